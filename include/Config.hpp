@@ -1,11 +1,29 @@
 #pragma once
 
+#include <memory>
+
 #include "json/DefaultConfig.hpp"
 
+// A config to use automatically for matching levels, where unset fields match anything
+DECLARE_JSON_STRUCT(ConfigProfile) {
+    // either a full path or relative to the configs folder
+    NAMED_VALUE(std::string, Config, "config");
+    NAMED_VALUE_OPTIONAL(std::string, LevelId, "levelId");
+    NAMED_VALUE_OPTIONAL(std::string, Characteristic, "characteristic");
+    NAMED_VALUE_OPTIONAL(std::string, Difficulty, "difficulty");
+};
+
 DECLARE_CONFIG(GlobalConfig) {
     CONFIG_VALUE(ModEnabled, bool, "isEnabled", true);
     CONFIG_VALUE(SelectedConfig, std::string, "selectedConfig", "");
     CONFIG_VALUE(HideUntilDone, bool, "hideUntilCalculated", false);
-    // not actually written to the config file
-    HSV::Config CurrentConfig = defaultConfig;
+    CONFIG_VALUE(ShowStats, bool, "showResultsStats", true);
+    CONFIG_VALUE(LogJudgements, bool, "logJudgments", false);
+    CONFIG_VALUE(StreamJudgements, bool, "streamJudgments", false);
+    CONFIG_VALUE(StreamPort, int, "streamPort", 14755);
+    CONFIG_VALUE(Profiles, std::vector<ConfigProfile>, "profiles", {});
+    CONFIG_VALUE(ConfigCacheBytes, int, "configCacheBytes", 8 * 1024 * 1024);
+    // not actually written to the config file, and set by FinishConfigLoad after loading during setup
+    // read only, so it can be shared with anything else judging without copies
+    std::shared_ptr<HSV::Config const> CurrentConfig;
 };
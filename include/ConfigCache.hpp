@@ -0,0 +1,23 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "json/Config.hpp"
+
+namespace HSV {
+    // Approximate heap and inline memory used by a loaded config
+    size_t EstimateSize(Config const& config);
+
+    // The most memory kept by cached configs that aren't in use, in bytes
+    void SetConfigCacheBudget(size_t bytes);
+
+    // Read, parse, and prepare a config file, or return it from the cache if the file hasn't been written since. Thread safe, and throws on errors.
+    std::shared_ptr<Config const> LoadConfig(std::string const& path);
+    // Returns a config only if it is already cached and the file hasn't been written since, without loading anything
+    std::shared_ptr<Config const> GetCachedConfig(std::string const& path);
+    // Load configs into the cache in order on another thread, ignoring any errors
+    void PreloadConfigs(std::vector<std::string> paths);
+    // Like PreloadConfigs, but cancels whatever is left from the previous call, so only the latest guesses are loaded
+    void PreloadSpeculative(std::vector<std::string> paths);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace HSV {
+    enum class EventType : uint8_t { Cut, WrongDirection, WrongColor, Bomb, Miss };
+
+    // A single judged note, small enough that recording one is just a copy into a queue
+    struct JudgmentEvent {
+        float songTime = 0;
+        float timeDependence = 0;
+        // the index in the list of judgements used for the cut, or -1 when none was
+        int16_t judgement = -1;
+        EventType type = EventType::Cut;
+        uint8_t scoringType = 0;
+        uint8_t before = 0;
+        uint8_t after = 0;
+        uint8_t accuracy = 0;
+        uint8_t wrongDirection = 0;
+    };
+
+    // Start recording a song to a new file, finishing the previous one if it was never ended
+    void BeginEventLog(std::string path);
+    // Never blocks or allocates, instead dropping the event if the writer has fallen too far behind
+    // Does nothing outside of a song being recorded
+    void LogEvent(JudgmentEvent const& event);
+    void EndEventLog();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <array>
+
+#include "UnityEngine/AnimationCurve.hpp"
+
+namespace HSV {
+    // A native copy of an AnimationCurve between 0 and 1, to avoid calling into il2cpp every frame
+    class FadeCurve {
+       public:
+        static constexpr int Samples = 64;
+
+        FadeCurve() = default;
+        explicit FadeCurve(UnityEngine::AnimationCurve* curve);
+
+        explicit operator bool() const { return sampled; }
+
+        // Linearly interpolated between samples, with t clamped to 0-1
+        float Evaluate(float t) const;
+
+       private:
+        std::array<float, Samples + 1> values = {};
+        bool sampled = false;
+    };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string_view>
+
+#include "FadeCurve.hpp"
+#include "TMPro/TextMeshPro.hpp"
+#include "UnityEngine/Color.hpp"
+#include "UnityEngine/MonoBehaviour.hpp"
+#include "custom-types/shared/macros.hpp"
+
+// A single persistent text used instead of pooled score effects when the config has a fixed position
+DECLARE_CLASS_CODEGEN(HSV, FixedDisplay, UnityEngine::MonoBehaviour) {
+    DECLARE_INSTANCE_FIELD(TMPro::TextMeshPro*, text);
+    DECLARE_INSTANCE_FIELD(float, elapsed);
+    DECLARE_INSTANCE_FIELD(float, duration);
+
+    DECLARE_CTOR(ctor);
+    DECLARE_INSTANCE_METHOD(void, Update);
+
+   public:
+    void Init(TMPro::TMP_Text* style, FadeCurve const& fade, UnityEngine::Vector3 position, float duration);
+    // Show a new cut, starting the fade over
+    void Show(std::string_view text, UnityEngine::Color color);
+    // Change what is showing for the same cut, leaving the fade where it is, or nothing if it already faded out
+    void Refresh(std::string_view text, UnityEngine::Color color);
+    void Hide();
+
+   private:
+    void PushFade();
+
+    FadeCurve fade;
+    UnityEngine::Color color;
+    // the alpha last pushed to the text, from 0 to 255, or -1 after the color was replaced
+    int pushedAlpha;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace HSV {
+    // A map for the handful of entries alive at once during gameplay, which stops allocating once its storage has grown to fit them
+    template <class K, class V>
+    class FlatMap {
+       public:
+        using Storage = std::vector<std::pair<K, V>>;
+        using iterator = typename Storage::iterator;
+
+        iterator begin() { return entries.begin(); }
+        iterator end() { return entries.end(); }
+
+        iterator find(K const& key) {
+            for (auto itr = entries.begin(); itr != entries.end(); itr++) {
+                if (itr->first == key)
+                    return itr;
+            }
+            return entries.end();
+        }
+        bool contains(K const& key) { return find(key) != entries.end(); }
+
+        void insert_or_assign(K const& key, V value) {
+            if (auto itr = find(key); itr != entries.end())
+                itr->second = std::move(value);
+            else
+                entries.emplace_back(key, std::move(value));
+        }
+
+        // order isn't preserved, so removal is just a swap with the last entry
+        void erase(iterator itr) {
+            *itr = std::move(entries.back());
+            entries.pop_back();
+        }
+        size_t erase(K const& key) {
+            auto itr = find(key);
+            if (itr == entries.end())
+                return 0;
+            erase(itr);
+            return 1;
+        }
+
+        // keeps the storage for reuse
+        void clear() { entries.clear(); }
+
+       private:
+        Storage entries;
+    };
+}
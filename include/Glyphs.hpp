@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TMPro/TMP_FontAsset.hpp"
+#include "json/Config.hpp"
+
+namespace HSV {
+    // Every unicode character a config could display, sorted and without duplicates, leaving out rich text tags and control characters
+    std::vector<uint32_t> CollectGlyphs(Config const& config);
+
+    // Add glyphs to the atlas of font or its fallbacks ahead of time, returning the ones none of them have
+    std::vector<uint32_t> PopulateGlyphs(TMPro::TMP_FontAsset* font, std::vector<uint32_t> const& glyphs);
+    // Check glyphs against font and its fallbacks without adding anything to their atlases, returning the ones none of them can display.
+    // Characters a dynamic font hasn't needed yet count as present if its source font has them.
+    std::vector<uint32_t> MissingGlyphs(TMPro::TMP_FontAsset* font, std::vector<uint32_t> const& glyphs);
+
+    std::string GlyphsToString(std::vector<uint32_t> const& glyphs);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "GlobalNamespace/NoteData.hpp"
+#include "Stats.hpp"
+#include "TokenizedText.hpp"
+#include "UnityEngine/Color.hpp"
+#include "json/Config.hpp"
+
+namespace HSV {
+    enum class Direction { Up, UpRight, Right, DownRight, Down, DownLeft, Left, UpLeft, None };
+
+    enum class BadCutType { WrongDirection, WrongColor, Bomb };
+
+    struct CutScores {
+        int total = 0;
+        int before = 0;
+        int after = 0;
+        int accuracy = 0;
+        float timeDependence = 0;
+        int maxScore = 0;
+        GlobalNamespace::NoteData::ScoringType scoringType = GlobalNamespace::NoteData::ScoringType::Normal;
+        Direction wrongDirection = Direction::None;
+    };
+
+    // Everything written while judging, so that any number of threads can judge with the same config using their own contexts
+    struct JudgeContext {
+        TokenizedText::Values values;
+        std::string text;
+
+        int wrongDirectionsCounter = 0;
+        int wrongColorsCounter = 0;
+        int bombsCounter = 0;
+        int missesCounter = 0;
+        std::default_random_engine rng{std::random_device()()};
+
+        // only updated for notes as they finish, and read for tokens like %r
+        SongStats stats;
+    };
+
+    struct JudgeResult {
+        // points into either the config or the context, so it is only valid until either changes
+        std::string_view text;
+        UnityEngine::Color color;
+        // the index of the judgement used, the same as from GetUsedJudgement
+        int16_t judgement;
+    };
+
+    // Optimize the config's texts and build its lookup tables once it is loaded, returning the bytes of rich text removed
+    size_t PrepareForJudging(Config& config);
+
+    JudgeResult JudgeCut(Config const& config, CutScores const& scores, JudgeContext& context);
+    // Returns null when the config has no displays for the type
+    BadCutDisplay const* GetBadCutDisplay(Config const& config, BadCutType type, JudgeContext& context);
+    MissDisplay const* GetMissDisplay(Config const& config, JudgeContext& context);
+    // The index and color of the judgement JudgeCut would use, though also for notes not displayed by the config
+    std::pair<int16_t, UnityEngine::Color> GetUsedJudgement(Config const& config, CutScores const& scores);
+}
@@ -1,21 +1,54 @@
 #pragma once
 
+#include <optional>
+
+#include "FixedDisplay.hpp"
 #include "GlobalNamespace/CutScoreBuffer.hpp"
 #include "GlobalNamespace/FlyingScoreEffect.hpp"
 #include "GlobalNamespace/FlyingTextSpawner.hpp"
 #include "GlobalNamespace/NoteController.hpp"
 #include "GlobalNamespace/NoteCutInfo.hpp"
+#include "Judgments.hpp"
+#include "Stats.hpp"
+#include "TMPro/TMP_FontAsset.hpp"
 #include "beatsaber-hook/shared/utils/logging.hpp"
+#include "json/Config.hpp"
 
 constexpr auto logger = Paper::ConstLoggerContext(MOD_ID);
 
 std::string ConfigsPath();
+std::string EventLogsPath();
+std::string ValidationReportPath();
 
+std::shared_ptr<HSV::Config const> GetDefaultConfig();
 void LoadCurrentConfig();
-void Judge(
+// The font of the score effects, found among the loaded fonts until a song has been played, or null if it isn't loaded
+TMPro::TMP_FontAsset* GameplayFont();
+// Makes sure the config loaded at startup is in use, waiting for it if needed. Must be called before anything using the current config.
+void FinishConfigLoad();
+void UpdateActiveHooks();
+void PrepareConfig(HSV::Config& config);
+// A cut as it was judged for display, so recording it once finished doesn't need to score or judge it again
+struct JudgedCut {
+    HSV::CutScores scores;
+    int16_t judgement;
+    UnityEngine::Color color;
+};
+// Both return nullopt when the cut wasn't judged, like when it is hidden until finished
+std::optional<JudgedCut> Judge(
     GlobalNamespace::CutScoreBuffer* cutScoreBuffer,
     GlobalNamespace::FlyingScoreEffect* flyingScoreEffect,
     GlobalNamespace::NoteCutInfo const& noteCutInfo
 );
+// Show the cut on the fixed display, restarting its fade if the cut is taking over the display rather than updating it
+std::optional<JudgedCut> JudgeFixed(GlobalNamespace::CutScoreBuffer* cutScoreBuffer, HSV::FixedDisplay* display, bool newCut);
 bool SpawnBadCut(GlobalNamespace::FlyingTextSpawner* spawner, GlobalNamespace::NoteCutInfo const& noteCutInfo);
 bool SpawnMiss(GlobalNamespace::FlyingTextSpawner* spawner, GlobalNamespace::NoteController* note, float z);
+// record finished notes for the stats and any logging or streaming
+// cuts that weren't judged for display, like chain notes left to the game, are scored and judged here instead
+void RecordCut(GlobalNamespace::CutScoreBuffer* cutScoreBuffer, std::optional<JudgedCut> const& judged);
+// bad cuts and misses are recorded before the check that skips displaying them for notes long past, as they count all the same
+void RecordBadCut(GlobalNamespace::NoteCutInfo const& noteCutInfo);
+void RecordMiss(GlobalNamespace::NoteController* note);
+void ResetStats();
+HSV::SongStats const& GetStats();
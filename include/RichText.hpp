@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "TokenizedText.hpp"
+
+namespace HSV {
+    // Remove tags with nothing at all between them, such as <u></u>, for tags that only affect the text they enclose.
+    // Anything inside <noparse> is left alone, since it is displayed as written.
+    void RemoveEmptyTags(std::string& text);
+    // Remove closing tags of the same kind at the very end of a text, where there is nothing left for them to affect
+    void RemoveTrailingClosingTags(std::string& text);
+    // Whether text opens a <noparse> without closing it, so tags in anything appended to it are displayed as written
+    bool OpensNoparse(std::string_view text);
+    // The closing tags for any scoped tags or <noparse> that text leaves open, innermost first, so that text after it displays as it would on its own
+    std::string ClosingTags(std::string_view text);
+
+    // Apply the above to the literals of a judgment template, returning the number of bytes removed
+    size_t OptimizeRichText(TokenizedText& text);
+}
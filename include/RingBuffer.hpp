@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace HSV {
+    // A fixed size queue for one producer thread and one consumer thread that never blocks or allocates
+    template <class T, size_t N>
+    class RingBuffer {
+        static_assert(N > 0 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+       public:
+        // Returns false without modifying the queue when it is full
+        bool TryPush(T const& value) {
+            size_t head = this->head.load(std::memory_order_relaxed);
+            if (head - tail.load(std::memory_order_acquire) == N)
+                return false;
+            items[head & (N - 1)] = value;
+            this->head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::optional<T> TryPop() {
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            if (tail == head.load(std::memory_order_acquire))
+                return std::nullopt;
+            T ret = items[tail & (N - 1)];
+            this->tail.store(tail + 1, std::memory_order_release);
+            return ret;
+        }
+
+       private:
+        std::array<T, N> items;
+        // separate cache lines so the two threads don't contend on each other's index
+        alignas(64) std::atomic<size_t> head = 0;
+        alignas(64) std::atomic<size_t> tail = 0;
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <map>
+#include <functional>
+#include <string_view>
+#include <vector>
 
 #include "GlobalNamespace/SimpleTextTableCell.hpp"
 #include "HMUI/TableCell.hpp"
@@ -25,8 +27,25 @@ DECLARE_CLASS_CODEGEN_INTERFACES(HSV, CustomList, UnityEngine::MonoBehaviour, HM
     DECLARE_OVERRIDE_METHOD_MATCH(int, NumberOfCells, &HMUI::TableView::IDataSource::NumberOfCells);
 
    public:
-    std::vector<std::string> data;
-    std::map<int, std::string> failures;
+    void Clear();
+    void Add(std::string_view name);
+    void AddFailure(std::string_view name, std::string error);
+    void AddWithHint(std::string_view name, std::string hint);
+
+    std::string_view GetName(int idx) const;
+    std::string const* GetFailure(int idx) const;
+    std::string const* GetHint(int idx) const;
+
+    // called with the index of a cell when it becomes highlighted
+    std::function<void(int)> onHighlight;
+
+   private:
+    // all names back to back, so thousands of configs don't mean thousands of allocations
+    std::string names;
+    std::vector<std::pair<uint32_t, uint32_t>> nameRanges;
+    // sorted by index, since entries are only ever appended
+    std::vector<std::pair<int, std::string>> failures;
+    std::vector<std::pair<int, std::string>> hints;
 };
 
 DECLARE_CLASS_CODEGEN(HSV, SettingsViewController, HMUI::ViewController) {
@@ -34,10 +53,17 @@ DECLARE_CLASS_CODEGEN(HSV, SettingsViewController, HMUI::ViewController) {
 
     DECLARE_INSTANCE_FIELD(BSML::ToggleSetting*, enabledToggle);
     DECLARE_INSTANCE_FIELD(BSML::ToggleSetting*, hideToggle);
+    DECLARE_INSTANCE_FIELD(BSML::ToggleSetting*, statsToggle);
+    DECLARE_INSTANCE_FIELD(BSML::ToggleSetting*, logToggle);
+    DECLARE_INSTANCE_FIELD(BSML::ToggleSetting*, streamToggle);
     DECLARE_INSTANCE_FIELD(TMPro::TextMeshProUGUI*, selectedConfig);
     DECLARE_INSTANCE_FIELD(HSV::CustomList*, configList);
+    DECLARE_INSTANCE_FIELD(TMPro::TextMeshProUGUI*, previewText);
 
     DECLARE_INSTANCE_METHOD(void, ConfigSelected, int idx);
+    DECLARE_INSTANCE_METHOD(void, ConfigHighlighted, int idx);
+    DECLARE_INSTANCE_METHOD(void, ShowPreview, int idx);
+    DECLARE_INSTANCE_METHOD(void, Update);
     DECLARE_INSTANCE_METHOD(void, RefreshConfigList);
     DECLARE_INSTANCE_METHOD(void, RefreshUI);
 
@@ -48,4 +74,6 @@ DECLARE_CLASS_CODEGEN(HSV, SettingsViewController, HMUI::ViewController) {
    private:
     static std::vector<std::string> fullConfigPaths;
     static int selectedIdx;
+    // the config to preview once it finishes loading, or -1
+    static int pendingPreviewIdx;
 };
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace HSV {
+    struct Config;
+    struct CutScores;
+
+    // Running totals for a song, entirely in fixed size arrays so that adding a note never allocates
+    struct SongStats {
+        enum Category { Normal, ChainHead, ChainLink, CategoryCount };
+
+        static constexpr int Hands = 2;
+        static constexpr int MaxBefore = 70;
+        static constexpr int MaxAfter = 30;
+        static constexpr int MaxAccuracy = 15;
+        // later judgements are all counted in the last
+        static constexpr int MaxJudgements = 32;
+        static constexpr int TimeDependenceBins = 20;
+        static constexpr int Columns = 4;
+        static constexpr int Rows = 3;
+        static constexpr int RollingCount = 10;
+
+        template <int Max>
+        using Histogram = std::array<std::array<std::array<uint32_t, Max + 1>, CategoryCount>, Hands>;
+
+        Histogram<MaxBefore> before = {};
+        Histogram<MaxAfter> after = {};
+        Histogram<MaxAccuracy> accuracy = {};
+        std::array<std::array<uint32_t, MaxJudgements>, CategoryCount> judgements = {};
+        std::array<uint32_t, TimeDependenceBins> timeDependence = {};
+        // indexed by row from the bottom, then column from the left, for normal notes only
+        std::array<std::array<uint32_t, Columns>, Rows> cellCuts = {};
+        std::array<std::array<uint32_t, Columns>, Rows> cellAccuracy = {};
+        uint32_t badCuts = 0;
+        uint32_t misses = 0;
+
+        // the totals of the most recent normal notes and chain heads, as a ring
+        std::array<int, RollingCount> recent = {};
+        int recentCount = 0;
+        int recentSum = 0;
+
+        // Adds a finished cut, where hand is 0 for left and 1 for right, and column and row are its position in the grid
+        void AddCut(CutScores const& scores, int hand, int judgement, int column, int row);
+        // The average total score of the most recent cuts, not counting chain links
+        float RollingAverage() const { return recentCount ? (float) recentSum / std::min(recentCount, RollingCount) : 0; }
+    };
+
+    // Readable summary of everything in the stats, for the results screen
+    std::string StatsSummary(SongStats const& stats, Config const& config);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+#include "EventLog.hpp"
+#include "UnityEngine/Color.hpp"
+
+namespace HSV {
+    // Starts, stops, or moves the localhost server sending judgments to any connected clients, not retrying a port that failed to open until it changes
+    void UpdateStreamServer(bool enabled, int port);
+    // Blocks until the server has accepted any pending connections and handed every event streamed before the call to its clients
+    void FlushStream();
+    // Never blocks or allocates, instead dropping the event if the server has fallen thousands of events behind
+    void StreamEvent(JudgmentEvent const& event, int score, UnityEngine::Color color);
+}
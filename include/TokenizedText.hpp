@@ -1,155 +1,291 @@
 #pragma once
 
-#include <numeric>
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-// Create a setNAME method that reads from the name##Tokens field and sets all tokens listed.
-#define SET_TOKEN(name) \
-void set_##name(std::string_view name) { \
-    invalidate_text(); \
-    for (int idx : name##Tokens) \
-        tokens[idx] = name; \
-} \
+// A string literal usable as a template argument, so templates can be tokenized at compile time.
+template <size_t N>
+struct TemplateString {
+    consteval TemplateString(char const (&str)[N]) { std::copy_n(str, N, data); }
+    constexpr std::string_view view() const { return {data, N - 1}; }
+
+    char data[N] = {};
+};
 
 class TokenizedText {
    public:
-    TokenizedText() = default;
-    bool operator==(TokenizedText const&) const = default;
+    enum class Token : uint8_t {
+        Literal,
+        BeforeCut,
+        Accuracy,
+        AfterCut,
+        TimeDependency,
+        Percent,
+        BeforeCutSegment,
+        AccuracySegment,
+        AfterCutSegment,
+        TimeDependencySegment,
+        Score,
+        Direction,
+        RollingAverage,
+    };
+    static constexpr size_t TokenCount = (size_t) Token::RollingAverage + 1;
 
-    TokenizedText(std::string str) {
-        original = str;
-        // Parse the string into tokens, converting the string back is easy.
-        std::stringstream nonPercentStr;
-        int i = 0;
-        bool isPercent = false;
-        for (char const current : str) {
-            if (isPercent) {
-                std::string buffer;
-                if (current == 'n')
-                    tokens.emplace_back("\n");
-                else if (current == '%')
-                    tokens.emplace_back("%");
-                else {
-                    switch (current) {
-                        case 'b':
-                            beforeCutTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 'c':
-                            accuracyTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 'a':
-                            afterCutTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 't':
-                            timeDependencyTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 'B':
-                            beforeCutSegmentTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 'C':
-                            accuracySegmentTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 'A':
-                            afterCutSegmentTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 'T':
-                            timeDependencySegmentTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 's':
-                            scoreTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 'p':
-                            percentTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        case 'd':
-                            directionTokens.push_back(i);
-                            tokens.emplace_back("");
-                            break;
-                        default:
-                            // keep % when it doesn't correspond to a key
-                            auto str = std::string("%") + current;
-                            tokens.push_back(str);
-                            isPercent = false;
-                            i++;
-                            continue;
-                    }
-                }
-                isPercent = false;
-                i++;
-                continue;
-            } else if (current == '%') {
-                tokens.emplace_back(nonPercentStr.str());
-                nonPercentStr.str(std::string());
-                isPercent = true;
-                i++;
-            } else
-                nonPercentStr.put(current);
+    // A single token of a template. Literal text views either the template itself or a static string.
+    struct Piece {
+        Token token = Token::Literal;
+        std::string_view text;
+    };
+
+    template <size_t N>
+    struct Compiled {
+        std::string_view original;
+        std::array<Piece, N> pieces;
+    };
+
+    // The text to substitute for each token, only needing to be filled for the tokens a template uses
+    struct Values {
+        std::string_view operator[](Token token) const { return views[(size_t) token]; }
+        void Set(Token token, std::string_view value) { views[(size_t) token] = value; }
+        // Copies value into storage kept between uses, so only allocates when it is longer than ever before
+        void Store(Token token, std::string_view value) {
+            owned[(size_t) token].assign(value);
+            views[(size_t) token] = owned[(size_t) token];
+        }
+
+        std::array<std::string_view, TokenCount> views;
+        std::array<std::string, TokenCount> owned;
+    };
+
+    // Appends the formatted text to out, selected once per template based on its sequence of tokens
+    using Formatter = void (*)(TokenizedText const& text, Values const& values, std::string& out);
+
+    static constexpr Token TokenFor(char specifier) {
+        switch (specifier) {
+            case 'b':
+                return Token::BeforeCut;
+            case 'c':
+                return Token::Accuracy;
+            case 'a':
+                return Token::AfterCut;
+            case 't':
+                return Token::TimeDependency;
+            case 'B':
+                return Token::BeforeCutSegment;
+            case 'C':
+                return Token::AccuracySegment;
+            case 'A':
+                return Token::AfterCutSegment;
+            case 'T':
+                return Token::TimeDependencySegment;
+            case 's':
+                return Token::Score;
+            case 'p':
+                return Token::Percent;
+            case 'd':
+                return Token::Direction;
+            case 'r':
+                return Token::RollingAverage;
+            default:
+                return Token::Literal;
         }
-        if (nonPercentStr.str().size() != 0)
-            tokens.emplace_back(nonPercentStr.str());
     }
 
-    std::string Raw() { return original; }
-    // Get the token-joined string from creation of this
-    std::string Join() {
-        if (!textValid) {
-            textValid = true;
-            text = std::string();
-            for (auto const& piece : tokens)
-                text += piece;
+    // Split a template into pieces, calling onPiece for each in order.
+    // Usable at compile time, since pieces only ever view str or static strings.
+    template <class F>
+    static constexpr void Parse(std::string_view str, F&& onPiece) {
+        size_t literalStart = 0;
+        for (size_t i = 0; i < str.size(); i++) {
+            if (str[i] != '%')
+                continue;
+            if (i > literalStart)
+                onPiece(Piece{Token::Literal, str.substr(literalStart, i - literalStart)});
+            // a trailing % is dropped
+            literalStart = std::min(i + 2, str.size());
+            if (i + 1 == str.size())
+                break;
+            char const specifier = str[++i];
+            if (specifier == 'n')
+                onPiece(Piece{Token::Literal, "\n"});
+            else if (specifier == '%')
+                onPiece(Piece{Token::Literal, "%"});
+            else if (Token token = TokenFor(specifier); token != Token::Literal)
+                onPiece(Piece{token, {}});
+            else
+                // keep % when it doesn't correspond to a key
+                onPiece(Piece{Token::Literal, str.substr(i - 1, 2)});
         }
-        return text;
+        if (literalStart < str.size())
+            onPiece(Piece{Token::Literal, str.substr(literalStart)});
     }
 
-    void invalidate_text() { textValid = false; }
+    static constexpr size_t CountPieces(std::string_view str) {
+        size_t count = 0;
+        Parse(str, [&count](Piece) { count++; });
+        return count;
+    }
+
+    template <TemplateString Str>
+    static consteval auto Compile() {
+        Compiled<CountPieces(Str.view())> ret = {Str.view()};
+        size_t i = 0;
+        Parse(Str.view(), [&ret, &i](Piece piece) { ret.pieces[i++] = piece; });
+        return ret;
+    }
+
+    TokenizedText() = default;
+    bool operator==(TokenizedText const&) const = default;
+
+    TokenizedText(std::string str) : original(std::move(str)) {
+        Parse(original, [this](Piece piece) { AddPiece(piece); });
+        SelectFormatter();
+    }
+
+    // Build from a template already tokenized at compile time, skipping parsing entirely.
+    template <size_t N>
+    TokenizedText(Compiled<N> const& compiled) : original(compiled.original) {
+        tokens.reserve(N);
+        for (auto const& piece : compiled.pieces)
+            AddPiece(piece);
+        SelectFormatter();
+    }
+
+    std::string Raw() const { return original; }
+
+    // Whether the template contains token at least once
+    bool Uses(Token token) const { return usedTokens & (1 << (size_t) token); }
 
-    bool is_text_valid() { return textValid; }
+    // Append the template to out with each token replaced by its value
+    void Format(Values const& values, std::string& out) const { formatter(*this, values, out); }
 
-    SET_TOKEN(beforeCut)
-    SET_TOKEN(accuracy)
-    SET_TOKEN(afterCut)
-    SET_TOKEN(timeDependency)
-    SET_TOKEN(percent)
-    SET_TOKEN(beforeCutSegment)
-    SET_TOKEN(accuracySegment)
-    SET_TOKEN(afterCutSegment)
-    SET_TOKEN(timeDependencySegment)
-    SET_TOKEN(score)
-    SET_TOKEN(direction)
+    // Rewrite each literal in place, as transform(std::string& literal, bool isLast), dropping any left empty
+    template <class F>
+    void TransformLiterals(F&& transform) {
+        auto oldTokens = std::move(tokens);
+        auto oldTypes = std::move(tokenTypes);
+        tokens.clear();
+        tokenTypes.clear();
+        usedTokens = 0;
+        for (size_t i = 0; i < oldTokens.size(); i++) {
+            if (oldTypes[i] == Token::Literal)
+                transform(oldTokens[i], i == oldTokens.size() - 1);
+            AddPiece(Piece{oldTypes[i], oldTokens[i]});
+        }
+        SelectFormatter();
+    }
 
     std::string original;
+    // The text of each literal, or empty for other tokens
     std::vector<std::string> tokens;
+    // The type of each entry in tokens, with adjacent literals merged into one
+    std::vector<Token> tokenTypes;
 
    private:
-    // Is cached text valid? Should be invalidated on tokens change
-    bool textValid = false;
-    // Cached text, should be invalidated on tokens change
-    std::string text;
-
-    std::vector<int> beforeCutTokens;
-    std::vector<int> accuracyTokens;
-    std::vector<int> afterCutTokens;
-    std::vector<int> timeDependencyTokens;
-    std::vector<int> percentTokens;
-    std::vector<int> beforeCutSegmentTokens;
-    std::vector<int> accuracySegmentTokens;
-    std::vector<int> afterCutSegmentTokens;
-    std::vector<int> timeDependencySegmentTokens;
-    std::vector<int> scoreTokens;
-    std::vector<int> directionTokens;
+    void AddPiece(Piece const& piece) {
+        if (piece.token == Token::Literal && piece.text.empty())
+            return;
+        if (piece.token == Token::Literal && !tokenTypes.empty() && tokenTypes.back() == Token::Literal) {
+            tokens.back() += piece.text;
+            return;
+        }
+        if (piece.token != Token::Literal)
+            usedTokens |= 1 << (size_t) piece.token;
+        tokens.emplace_back(piece.text);
+        tokenTypes.push_back(piece.token);
+    }
+
+    void SelectFormatter();
+
+    uint16_t usedTokens = 0;
+    Formatter formatter = nullptr;
 };
 
-#undef SET_TOKEN
+namespace TokenFormatters {
+    using Token = TokenizedText::Token;
+
+    // Works for any template, looking up the type of each token as it goes
+    inline void Generic(TokenizedText const& text, TokenizedText::Values const& values, std::string& out) {
+        for (size_t i = 0; i < text.tokens.size(); i++)
+            out += text.tokenTypes[i] == Token::Literal ? std::string_view(text.tokens[i]) : values[text.tokenTypes[i]];
+    }
+
+    // A formatter for one exact sequence of tokens, fully unrolled at compile time
+    template <Token... Shape>
+    struct Specialized {
+        static constexpr std::array<Token, sizeof...(Shape)> shape = {Shape...};
+
+        static void Format(TokenizedText const& text, TokenizedText::Values const& values, std::string& out) {
+            Append(text, values, out, std::make_index_sequence<sizeof...(Shape)>());
+        }
+
+       private:
+        template <Token Part>
+        static std::string_view Get(TokenizedText const& text, TokenizedText::Values const& values, size_t idx) {
+            if constexpr (Part == Token::Literal)
+                return text.tokens[idx];
+            else
+                return values[Part];
+        }
+
+        template <size_t... Idxs>
+        static void Append(TokenizedText const& text, TokenizedText::Values const& values, std::string& out, std::index_sequence<Idxs...>) {
+            std::string_view const parts[] = {Get<Shape>(text, values, Idxs)...};
+            // one resize and a copy of each part, rather than a capacity check for each append
+            size_t const start = out.size();
+            out.resize(start + (parts[Idxs].size() + ...));
+            char* dest = out.data() + start;
+            ((std::memcpy(dest, parts[Idxs].data(), parts[Idxs].size()), dest += parts[Idxs].size()), ...);
+        }
+    };
+
+    struct Entry {
+        Token const* shape;
+        size_t size;
+        TokenizedText::Formatter format;
+    };
+
+    template <class T>
+    constexpr Entry MakeEntry() {
+        return {T::shape.data(), T::shape.size(), &T::Format};
+    }
+
+    constexpr auto L = Token::Literal;
+    constexpr auto S = Token::Score;
+    constexpr auto P = Token::Percent;
+    constexpr auto B = Token::BeforeCutSegment;
+    constexpr auto C = Token::AccuracySegment;
+    constexpr auto A = Token::AfterCutSegment;
+
+    // The template shapes seen most often, including everything in the default config
+    inline constexpr Entry Specializations[] = {
+        MakeEntry<Specialized<S>>(),  // %s
+        MakeEntry<Specialized<L, S>>(),  // <size=80%>%s
+        MakeEntry<Specialized<L, S, L>>(),  // <size=150%><u>%s</u></size>
+        MakeEntry<Specialized<S, L, P, L>>(),  // %s%n%p%%
+        MakeEntry<Specialized<B, S, A>>(),  // %B%s%A
+        MakeEntry<Specialized<B, C, S, L, A>>(),  // %B%C%s</u>%A
+        MakeEntry<Specialized<B, L, S, L, A>>(),  // %B<size=80%>%s</size>%A
+        MakeEntry<Specialized<B, L, C, S, L, A>>(),  // %B<size=120%>%C%s</u></size>%A
+    };
+}
+
+inline void TokenizedText::SelectFormatter() {
+    formatter = &TokenFormatters::Generic;
+    for (auto const& entry : TokenFormatters::Specializations) {
+        if (std::equal(tokenTypes.begin(), tokenTypes.end(), entry.shape, entry.shape + entry.size)) {
+            formatter = entry.format;
+            return;
+        }
+    }
+}
+
+// A template tokenized at compile time, for building TokenizedText without any parsing.
+template <TemplateString Str>
+inline constexpr auto CompiledText = TokenizedText::Compile<Str>();
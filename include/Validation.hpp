@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace HSV {
+    struct ValidationResult {
+        std::string path;
+        std::optional<std::string> error;
+        std::chrono::microseconds parseTime;
+        std::vector<uint32_t> glyphs;
+    };
+
+    // Test load every config in paths across a pool of threads, one per core unless maxThreads is set, with results in the same order as paths
+    std::vector<ValidationResult> ValidateConfigs(std::vector<std::string> const& paths, size_t maxThreads = 0);
+    // Replace the file at path with a tab separated table of results, one line for each config after a header
+    void WriteValidationReport(std::string const& path, std::vector<ValidationResult> const& results);
+}
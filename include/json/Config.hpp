@@ -34,11 +34,12 @@ namespace HSV {
         NAMED_VALUE_OPTIONAL(bool, Fade, "fade");
         TokenizedText Text;
 
-        Judgement(int threshold, std::string text, UnityEngine::Color color, bool fade = false) :
-            Threshold(threshold),
-            Text(text),
+        Judgement(int threshold, TokenizedText text, UnityEngine::Color color, bool fade = false) :
+            UnprocessedText(text.original),
             Color(color),
-            Fade(fade) {}
+            Threshold(threshold),
+            Fade(fade),
+            Text(std::move(text)) {}
         Judgement() = default;
     };
 
@@ -94,6 +95,12 @@ namespace HSV {
         NAMED_VALUE_OPTIONAL(ConfigUtils::Vector3, UnprocessedPosOffset, "targetPositionOffset");
         NAMED_VALUE_DEFAULT(int, TimeDependenceDecimalPrecision, 1, "timeDependencyDecimalPrecision");
         NAMED_VALUE_DEFAULT(int, TimeDependenceDecimalOffset, 2, "timeDependencyDecimalOffset");
+        DESERIALIZE_FUNCTION(ValidateTimeDependence) {
+            if (TimeDependenceDecimalPrecision < 0 || TimeDependenceDecimalPrecision > 99)
+                throw JSONException("timeDependencyDecimalPrecision must be between 0 and 99");
+            if (TimeDependenceDecimalOffset < 0 || TimeDependenceDecimalOffset > 38)
+                throw JSONException("timeDependencyDecimalOffset must be between 0 and 38");
+        };
         NAMED_VECTOR_DEFAULT(BadCutDisplay, BadCutDisplays, {}, "badCutDisplays");
         NAMED_VALUE_DEFAULT(bool, RandomizeBadCutDisplays, true, "randomizeBadCutDisplays");
         NAMED_VECTOR_DEFAULT(MissDisplay, MissDisplays, {}, "missDisplays");
@@ -106,6 +113,11 @@ namespace HSV {
         std::vector<BadCutDisplay> WrongColors;
         std::vector<BadCutDisplay> Bombs;
 
+        // the chain link text for each possible score, filled by PrepareConfig when only the score affects it
+        std::vector<std::string> ChainLinkTexts;
+        // every character the config can display, filled by PrepareConfig
+        std::vector<uint32_t> Glyphs;
+
         DESERIALIZE_FUNCTION(ConvertPositions) {
             if (UseFixedPos.has_value() && UseFixedPos.value())
                 FixedPos = {FixedPosX.value_or(0), FixedPosY.value_or(0), FixedPosZ.value_or(0)};
@@ -129,10 +141,10 @@ namespace HSV {
             }
         };
 
-        bool HasChainHead() {
+        bool HasChainHead() const {
             return ChainHeadJudgements.size() > 0;
         };
-        bool HasChainLink() {
+        bool HasChainLink() const {
             return ChainLinkDisplay.has_value();
         };
     };
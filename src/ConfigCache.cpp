@@ -0,0 +1,198 @@
+#include "ConfigCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "Main.hpp"
+
+using namespace HSV;
+
+namespace {
+    struct Entry {
+        std::string path;
+        std::shared_ptr<Config const> config;
+        size_t size;
+        // of the file when it was read, so edits to it are picked up
+        std::filesystem::file_time_type modified;
+    };
+}
+
+// most recently used at the front
+static std::list<Entry> entries;
+static std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+static size_t cachedBytes = 0;
+static std::mutex cacheMutex;
+static std::atomic<size_t> budget = 8 * 1024 * 1024;
+
+static size_t SizeOf(std::string const& str) {
+    // short strings are stored inline
+    return sizeof(std::string) + (str.capacity() >= sizeof(std::string) ? str.capacity() : 0);
+}
+
+template <class T, class F>
+static size_t SizeOf(std::vector<T> const& vec, F&& sizeOf) {
+    size_t ret = sizeof(vec) + (vec.capacity() - vec.size()) * sizeof(T);
+    for (auto& item : vec)
+        ret += sizeOf(item);
+    return ret;
+}
+
+static size_t SizeOf(TokenizedText const& text) {
+    return sizeof(TokenizedText) + SizeOf(text.original) + SizeOf(text.tokens, [](auto& str) { return SizeOf(str); }) +
+           text.tokenTypes.capacity() * sizeof(TokenizedText::Token);
+}
+
+static size_t SizeOf(Judgement const& judgement) {
+    return sizeof(Judgement) + SizeOf(judgement.UnprocessedText) + SizeOf(judgement.Text);
+}
+
+size_t HSV::EstimateSize(Config const& config) {
+    auto judgement = [](Judgement const& judgement) { return SizeOf(judgement); };
+    auto text = [](auto const& item) { return sizeof(item) + SizeOf(item.Text); };
+    size_t ret = sizeof(Config);
+    ret += SizeOf(config.Judgements, judgement);
+    ret += SizeOf(config.ChainHeadJudgements, judgement);
+    if (config.ChainLinkDisplay)
+        ret += SizeOf(*config.ChainLinkDisplay);
+    ret += SizeOf(config.BeforeCutAngleSegments, text);
+    ret += SizeOf(config.AccuracySegments, text);
+    ret += SizeOf(config.AfterCutAngleSegments, text);
+    ret += SizeOf(config.TimeDependenceSegments, text);
+    ret += SizeOf(config.BadCutDisplays, text);
+    ret += SizeOf(config.MissDisplays, text);
+    ret += SizeOf(config.WrongDirections, text);
+    ret += SizeOf(config.WrongColors, text);
+    ret += SizeOf(config.Bombs, text);
+    ret += SizeOf(config.ChainLinkTexts, [](auto& str) { return SizeOf(str); });
+    ret += config.Glyphs.capacity() * sizeof(uint32_t);
+    return ret;
+}
+
+// the time the file was last written, or the minimum if that can't be read, making it reload the next time it can be
+static std::filesystem::file_time_type LastWrite(std::string const& path) {
+    std::error_code error;
+    auto ret = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : ret;
+}
+
+// must be called with the mutex held
+static void Remove(std::list<Entry>::iterator entry) {
+    cachedBytes -= entry->size;
+    lookup.erase(entry->path);
+    entries.erase(entry);
+}
+
+// must be called with the mutex held, returning the entry for path only if the file hasn't changed since it was read
+static std::list<Entry>::iterator Find(std::string const& path, std::filesystem::file_time_type modified) {
+    auto itr = lookup.find(path);
+    if (itr == lookup.end())
+        return entries.end();
+    if (itr->second->modified != modified) {
+        logger.debug("Config {} changed since it was cached", path);
+        Remove(itr->second);
+        return entries.end();
+    }
+    return itr->second;
+}
+
+// must be called with the mutex held
+static void Evict() {
+    // always keep the most recent, even if it alone is over the budget
+    while (cachedBytes > budget && entries.size() > 1)
+        Remove(std::prev(entries.end()));
+}
+
+void HSV::SetConfigCacheBudget(size_t bytes) {
+    budget = bytes;
+    std::unique_lock lock(cacheMutex);
+    Evict();
+}
+
+std::shared_ptr<Config const> HSV::GetCachedConfig(std::string const& path) {
+    auto modified = LastWrite(path);
+    std::unique_lock lock(cacheMutex);
+    auto entry = Find(path, modified);
+    return entry != entries.end() ? entry->config : nullptr;
+}
+
+std::shared_ptr<Config const> HSV::LoadConfig(std::string const& path) {
+    // checked before reading, so a write during the read is picked up next time
+    auto modified = LastWrite(path);
+    {
+        std::unique_lock lock(cacheMutex);
+        if (auto entry = Find(path, modified); entry != entries.end()) {
+            entries.splice(entries.begin(), entries, entry);
+            return entry->config;
+        }
+    }
+    // parse without holding the lock, so other loads aren't blocked on it
+    auto config = std::make_shared<Config>();
+    ReadFromFile(path, *config);
+    PrepareConfig(*config);
+    size_t size = EstimateSize(*config);
+
+    std::unique_lock lock(cacheMutex);
+    // another thread may have loaded the same file in the meantime
+    if (auto entry = Find(path, modified); entry != entries.end())
+        return entry->config;
+    // or an older version of it
+    if (auto itr = lookup.find(path); itr != lookup.end())
+        Remove(itr->second);
+    entries.push_front({path, config, size, modified});
+    lookup.emplace(path, entries.begin());
+    cachedBytes += size;
+    Evict();
+    logger.debug("Cached config {} ({} bytes, {} total)", path, size, cachedBytes);
+    return config;
+}
+
+void HSV::PreloadConfigs(std::vector<std::string> paths) {
+    std::thread([paths = std::move(paths)]() {
+        for (auto& path : paths) {
+            try {
+                LoadConfig(path);
+            } catch (std::exception const& err) {
+                logger.warn("Could not preload config {}: {}", path, err.what());
+            }
+        }
+    }).detach();
+}
+
+// in reverse order, so the next to load is at the back
+static std::vector<std::string> speculativePaths;
+static std::mutex speculativeMutex;
+static std::condition_variable speculativeCondition;
+
+static void SpeculativeThread() {
+    while (true) {
+        std::string path;
+        {
+            std::unique_lock lock(speculativeMutex);
+            speculativeCondition.wait(lock, []() { return !speculativePaths.empty(); });
+            path = std::move(speculativePaths.back());
+            speculativePaths.pop_back();
+        }
+        try {
+            LoadConfig(path);
+        } catch (std::exception const& err) {
+            logger.warn("Could not preload config {}: {}", path, err.what());
+        }
+    }
+}
+
+void HSV::PreloadSpeculative(std::vector<std::string> paths) {
+    static std::once_flag started;
+    std::call_once(started, []() { std::thread(SpeculativeThread).detach(); });
+    std::reverse(paths.begin(), paths.end());
+    {
+        std::unique_lock lock(speculativeMutex);
+        speculativePaths = std::move(paths);
+    }
+    speculativeCondition.notify_one();
+}
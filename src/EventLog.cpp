@@ -0,0 +1,152 @@
+#include "EventLog.hpp"
+
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Main.hpp"
+#include "RingBuffer.hpp"
+
+using namespace HSV;
+
+namespace {
+    struct Entry {
+        enum class Kind : uint8_t { Event, Begin, End } kind = Kind::Event;
+        JudgmentEvent event;
+    };
+
+    // each field stored contiguously, so that the file compresses well and can be read one field at a time
+    struct Columns {
+        std::vector<float> songTime;
+        std::vector<float> timeDependence;
+        std::vector<int16_t> judgement;
+        std::vector<uint8_t> type;
+        std::vector<uint8_t> scoringType;
+        std::vector<uint8_t> before;
+        std::vector<uint8_t> after;
+        std::vector<uint8_t> accuracy;
+        std::vector<uint8_t> wrongDirection;
+
+        void Add(JudgmentEvent const& event) {
+            songTime.push_back(event.songTime);
+            timeDependence.push_back(event.timeDependence);
+            judgement.push_back(event.judgement);
+            type.push_back((uint8_t) event.type);
+            scoringType.push_back(event.scoringType);
+            before.push_back(event.before);
+            after.push_back(event.after);
+            accuracy.push_back(event.accuracy);
+            wrongDirection.push_back(event.wrongDirection);
+        }
+
+        template <class F>
+        void ForEach(F&& func) {
+            func(songTime);
+            func(timeDependence);
+            func(judgement);
+            func(type);
+            func(scoringType);
+            func(before);
+            func(after);
+            func(accuracy);
+            func(wrongDirection);
+        }
+    };
+}
+
+static constexpr char FileMagic[4] = {'H', 'S', 'V', 'L'};
+static constexpr uint32_t FileVersion = 1;
+
+// a few minutes of the densest maps, as the writer drains it constantly
+static RingBuffer<Entry, 8192> queue;
+static std::atomic<uint32_t> dropped = 0;
+
+// only used on the main thread
+static bool open = false;
+
+// only touched when songs start, never while judging
+static std::mutex pathsMutex;
+static std::deque<std::string> pendingPaths;
+
+static void WriteFile(std::string const& path, Columns& columns) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        logger.error("Could not open judgment log {}", path);
+        return;
+    }
+    uint32_t count = columns.songTime.size();
+    file.write(FileMagic, sizeof(FileMagic));
+    file.write((char const*) &FileVersion, sizeof(FileVersion));
+    file.write((char const*) &count, sizeof(count));
+    columns.ForEach([&file](auto const& column) { file.write((char const*) column.data(), column.size() * sizeof(column[0])); });
+    logger.info("Wrote {} judgments to {} ({} dropped)", count, path, dropped.exchange(0));
+}
+
+static void WriterThread() {
+    std::optional<std::string> path;
+    Columns columns;
+    while (true) {
+        auto entry = queue.TryPop();
+        if (!entry) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
+        }
+        switch (entry->kind) {
+            case Entry::Kind::Event:
+                if (path)
+                    columns.Add(entry->event);
+                break;
+            case Entry::Kind::End:
+                if (path)
+                    WriteFile(*path, columns);
+                path.reset();
+                columns = {};
+                break;
+            case Entry::Kind::Begin: {
+                if (path)
+                    WriteFile(*path, columns);
+                columns = {};
+                std::unique_lock lock(pathsMutex);
+                path = std::move(pendingPaths.front());
+                pendingPaths.pop_front();
+                break;
+            }
+        }
+    }
+}
+
+static void Push(Entry const& entry) {
+    if (!queue.TryPush(entry))
+        dropped++;
+}
+
+// song boundaries are never dropped, as a lost Begin would get the paths out of sync and a lost End would hold back the file until the next song
+static void PushBoundary(Entry::Kind kind) {
+    while (!queue.TryPush({.kind = kind}))
+        std::this_thread::yield();
+}
+
+void HSV::BeginEventLog(std::string path) {
+    static std::once_flag started;
+    std::call_once(started, []() { std::thread(WriterThread).detach(); });
+    {
+        std::unique_lock lock(pathsMutex);
+        pendingPaths.emplace_back(std::move(path));
+    }
+    PushBoundary(Entry::Kind::Begin);
+    open = true;
+}
+
+void HSV::LogEvent(JudgmentEvent const& event) {
+    if (open)
+        Push({.kind = Entry::Kind::Event, .event = event});
+}
+
+void HSV::EndEventLog() {
+    if (open)
+        PushBoundary(Entry::Kind::End);
+    open = false;
+}
@@ -0,0 +1,20 @@
+#include "FadeCurve.hpp"
+
+#include <algorithm>
+
+using namespace HSV;
+
+FadeCurve::FadeCurve(UnityEngine::AnimationCurve* curve) {
+    if (!curve)
+        return;
+    for (int i = 0; i <= Samples; i++)
+        values[i] = curve->Evaluate((float) i / Samples);
+    sampled = true;
+}
+
+float FadeCurve::Evaluate(float t) const {
+    float position = std::clamp(t, 0.0f, 1.0f) * Samples;
+    int idx = std::min((int) position, Samples - 1);
+    float lerp = position - idx;
+    return values[idx] + (values[idx + 1] - values[idx]) * lerp;
+}
@@ -0,0 +1,80 @@
+#include "FixedDisplay.hpp"
+
+#include "UnityEngine/Time.hpp"
+#include "UnityEngine/Transform.hpp"
+
+DEFINE_TYPE(HSV, FixedDisplay);
+
+using namespace HSV;
+
+void FixedDisplay::ctor() {
+    INVOKE_CTOR();
+    text = nullptr;
+    elapsed = 0;
+    duration = 0;
+    pushedAlpha = -1;
+}
+
+void FixedDisplay::Init(TMPro::TMP_Text* style, FadeCurve const& fade, UnityEngine::Vector3 position, float duration) {
+    text = gameObject->AddComponent<TMPro::TextMeshPro*>();
+    text->font = style->font;
+    text->fontSize = style->fontSize;
+    text->alignment = style->alignment;
+    text->richText = true;
+    text->enableWordWrapping = false;
+    text->overflowMode = TMPro::TextOverflowModes::Overflow;
+    text->text = "";
+    transform->position = position;
+    this->fade = fade;
+    this->duration = duration;
+    // only update while something is showing
+    enabled = false;
+}
+
+void FixedDisplay::Show(std::string_view text, UnityEngine::Color color) {
+    this->text->text = text;
+    this->color = color;
+    this->text->color = color;
+    pushedAlpha = -1;
+    elapsed = 0;
+    if (!enabled)
+        enabled = true;
+}
+
+void FixedDisplay::Refresh(std::string_view text, UnityEngine::Color color) {
+    if (!enabled)
+        return;
+    this->text->text = text;
+    this->color = color;
+    pushedAlpha = -1;
+    if (fade)
+        PushFade();
+    else
+        this->text->color = color;
+}
+
+void FixedDisplay::Hide() {
+    text->text = "";
+    enabled = false;
+}
+
+void FixedDisplay::Update() {
+    elapsed += UnityEngine::Time::get_deltaTime();
+    if (elapsed >= duration) {
+        Hide();
+        return;
+    }
+    if (fade)
+        PushFade();
+}
+
+// the color with the alpha of the fade at the elapsed time, skipped when it wouldn't visibly change
+void FixedDisplay::PushFade() {
+    float alpha = fade.Evaluate(elapsed / duration);
+    int quantized = std::lround(std::clamp(alpha, 0.0f, 1.0f) * 255);
+    if (quantized == pushedAlpha)
+        return;
+    pushedAlpha = quantized;
+    color.a = alpha;
+    text->color = color;
+}
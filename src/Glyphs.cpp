@@ -0,0 +1,157 @@
+#include "Glyphs.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+
+#include "System/Collections/Generic/List_1.hpp"
+#include "TMPro/AtlasPopulationMode.hpp"
+#include "UnityEngine/Font.hpp"
+
+using namespace HSV;
+
+// the > ending a tag TextMeshPro would parse at start, or npos when it would display it as text, like </3>
+static size_t TagEnd(std::string_view utf8, size_t start) {
+    size_t name = start + 1 < utf8.size() && utf8[start + 1] == '/' ? start + 2 : start + 1;
+    if (name >= utf8.size() || !(std::isalpha((unsigned char) utf8[name]) || utf8[name] == '#'))
+        return std::string::npos;
+    size_t end = utf8.find_first_of("<>", name);
+    return end != std::string::npos && utf8[end] == '>' ? end : std::string::npos;
+}
+
+static std::string TagName(std::string_view utf8, size_t start, size_t end) {
+    auto tag = utf8.substr(start + 1, end - start - 1);
+    std::string ret(tag.substr(0, tag.find_first_of("= ")));
+    std::transform(ret.begin(), ret.end(), ret.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ret;
+}
+
+static void AddGlyphs(std::vector<uint32_t>& glyphs, std::string_view utf8) {
+    bool noparse = false;
+    for (size_t i = 0; i < utf8.size();) {
+        uint8_t lead = utf8[i];
+        // tags aren't displayed, except inside noparse
+        if (size_t end = lead == '<' ? TagEnd(utf8, i) : std::string::npos; end != std::string::npos) {
+            std::string name = TagName(utf8, i, end);
+            if (!noparse || name == "/noparse") {
+                noparse = name == "noparse";
+                i = end + 1;
+                continue;
+            }
+        }
+        int length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xe ? 3 : (lead >> 3) == 0x1e ? 4 : 0;
+        // skip invalid bytes, the same as they won't be displayed
+        if (length == 0 || i + length > utf8.size()) {
+            i++;
+            continue;
+        }
+        uint32_t codepoint = length == 1 ? lead : lead & (0x7f >> length);
+        for (int j = 1; j < length; j++)
+            codepoint = (codepoint << 6) | (utf8[i + j] & 0x3f);
+        // control characters like the newline from %n have no glyph
+        if (codepoint >= 0x20)
+            glyphs.push_back(codepoint);
+        i += length;
+    }
+}
+
+static void AddGlyphs(std::vector<uint32_t>& glyphs, Judgement const& judgement) {
+    for (auto& token : judgement.Text.tokens)
+        AddGlyphs(glyphs, token);
+    if (judgement.Text.Uses(TokenizedText::Token::Direction))
+        AddGlyphs(glyphs, "↑↗→↘↓↙←↖");
+}
+
+std::vector<uint32_t> HSV::CollectGlyphs(Config const& config) {
+    // numbers are always possible, and would be in the font anyway
+    std::vector<uint32_t> glyphs;
+    AddGlyphs(glyphs, "0123456789.-");
+
+    for (auto& judgement : config.Judgements)
+        AddGlyphs(glyphs, judgement);
+    for (auto& judgement : config.ChainHeadJudgements)
+        AddGlyphs(glyphs, judgement);
+    if (config.ChainLinkDisplay)
+        AddGlyphs(glyphs, *config.ChainLinkDisplay);
+    for (auto segments : {&config.BeforeCutAngleSegments, &config.AccuracySegments, &config.AfterCutAngleSegments}) {
+        for (auto& segment : *segments)
+            AddGlyphs(glyphs, segment.Text);
+    }
+    for (auto& segment : config.TimeDependenceSegments)
+        AddGlyphs(glyphs, segment.Text);
+    for (auto& display : config.BadCutDisplays)
+        AddGlyphs(glyphs, display.Text);
+    for (auto& display : config.MissDisplays)
+        AddGlyphs(glyphs, display.Text);
+
+    std::sort(glyphs.begin(), glyphs.end());
+    glyphs.erase(std::unique(glyphs.begin(), glyphs.end()), glyphs.end());
+    return glyphs;
+}
+
+std::vector<uint32_t> HSV::PopulateGlyphs(TMPro::TMP_FontAsset* font, std::vector<uint32_t> const& glyphs) {
+    std::vector<uint32_t> missing;
+    if (!font)
+        return missing;
+    for (auto glyph : glyphs) {
+        // searches fallbacks and adds to dynamic atlases, which would otherwise happen the first time it's shown
+        if (!font->HasCharacter(glyph, true, true))
+            missing.push_back(glyph);
+    }
+    return missing;
+}
+
+// whether font or a fallback has glyph in its atlas, or would add it from its source font when it's first shown
+static bool CanDisplay(TMPro::TMP_FontAsset* font, uint32_t glyph, std::vector<TMPro::TMP_FontAsset*>& searched) {
+    // fallbacks can refer back to each other
+    if (!font || std::find(searched.begin(), searched.end(), font) != searched.end())
+        return false;
+    searched.push_back(font);
+    if (font->HasCharacter(glyph, false, false))
+        return true;
+    // the source font is checked a UTF-16 unit at a time, so anything past them is only found in an atlas
+    auto source = font->sourceFontFile;
+    if (font->atlasPopulationMode == TMPro::AtlasPopulationMode::Dynamic && source && glyph <= 0xffff && source->HasCharacter((char16_t) glyph))
+        return true;
+    auto fallbacks = font->fallbackFontAssetTable;
+    for (int i = 0; fallbacks && i < fallbacks->Count; i++) {
+        if (CanDisplay(fallbacks->get_Item(i), glyph, searched))
+            return true;
+    }
+    return false;
+}
+
+std::vector<uint32_t> HSV::MissingGlyphs(TMPro::TMP_FontAsset* font, std::vector<uint32_t> const& glyphs) {
+    std::vector<uint32_t> missing;
+    if (!font)
+        return missing;
+    std::vector<TMPro::TMP_FontAsset*> searched;
+    for (auto glyph : glyphs) {
+        searched.clear();
+        if (!CanDisplay(font, glyph, searched))
+            missing.push_back(glyph);
+    }
+    return missing;
+}
+
+std::string HSV::GlyphsToString(std::vector<uint32_t> const& glyphs) {
+    std::string ret;
+    for (auto glyph : glyphs) {
+        if (glyph < 0x80)
+            ret += (char) glyph;
+        else if (glyph < 0x800) {
+            ret += (char) (0xc0 | (glyph >> 6));
+            ret += (char) (0x80 | (glyph & 0x3f));
+        } else if (glyph < 0x10000) {
+            ret += (char) (0xe0 | (glyph >> 12));
+            ret += (char) (0x80 | ((glyph >> 6) & 0x3f));
+            ret += (char) (0x80 | (glyph & 0x3f));
+        } else {
+            ret += (char) (0xf0 | (glyph >> 18));
+            ret += (char) (0x80 | ((glyph >> 12) & 0x3f));
+            ret += (char) (0x80 | ((glyph >> 6) & 0x3f));
+            ret += (char) (0x80 | (glyph & 0x3f));
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,276 @@
+#include "Judgments.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+
+#include "Glyphs.hpp"
+#include "RichText.hpp"
+
+// Judging itself, kept apart from the hooks and without anything from il2cpp, so that it also builds for host tests
+
+using namespace HSV;
+using ScoringType = GlobalNamespace::NoteData::ScoringType;
+
+static std::string_view GetDirectionText(Direction wrongDirection) {
+    switch (wrongDirection) {
+        case Direction::Up:
+            return "↑";
+        case Direction::UpRight:
+            return "↗";
+        case Direction::Right:
+            return "→";
+        case Direction::DownRight:
+            return "↘";
+        case Direction::Down:
+            return "↓";
+        case Direction::DownLeft:
+            return "↙";
+        case Direction::Left:
+            return "←";
+        case Direction::UpLeft:
+            return "↖";
+        default:
+            return "";
+    }
+}
+
+static Judgement const& GetBestJudgement(std::vector<Judgement> const& judgements, int comparison) {
+    Judgement const* best = nullptr;
+    for (auto& judgement : judgements) {
+        if (comparison >= judgement.Threshold && (!best || judgement.Threshold > best->Threshold))
+            best = &judgement;
+    }
+    return best ? *best : judgements.back();
+}
+
+static std::string_view GetBestSegmentText(std::vector<Segment> const& segments, int comparison) {
+    Segment const* best = nullptr;
+    for (auto& segment : segments) {
+        if (comparison >= segment.Threshold && (!best || segment.Threshold > best->Threshold))
+            best = &segment;
+    }
+    return best ? std::string_view(best->Text) : "";
+}
+
+static std::string_view GetBestFloatSegmentText(std::vector<FloatSegment> const& segments, float comparison) {
+    FloatSegment const* best = nullptr;
+    for (auto& segment : segments) {
+        if (comparison >= segment.Threshold && (!best || segment.Threshold > best->Threshold))
+            best = &segment;
+    }
+    return best ? std::string_view(best->Text) : "";
+}
+
+// enough for a float of up to 10^38 with 99 decimal places
+using NumberBuffer = std::array<char, 160>;
+
+template <class T>
+static std::string_view ToChars(NumberBuffer& buffer, T value) {
+    auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    return {buffer.data(), result.ptr};
+}
+
+template <class T>
+static std::string_view ToChars(NumberBuffer& buffer, T value, int precision) {
+    auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed, precision);
+    return {buffer.data(), result.ptr};
+}
+
+static std::string_view TimeDependenceString(Config const& config, float timeDependence, NumberBuffer& buffer) {
+    // offsets up to 38 overflow an int but still fit in a float
+    float multiplier = std::pow(10.0f, config.TimeDependenceDecimalOffset);
+    return ToChars(buffer, timeDependence * multiplier, config.TimeDependenceDecimalPrecision);
+}
+
+static void FormatJudgementText(Config const& config, Judgement const& judgement, CutScores const& scores, JudgeContext& context) {
+    using Token = TokenizedText::Token;
+
+    auto& text = judgement.Text;
+    auto& values = context.values;
+    NumberBuffer buffer;
+
+    // only compute what the template actually displays, formatting numbers without any allocations
+    if (text.Uses(Token::BeforeCut))
+        values.Store(Token::BeforeCut, ToChars(buffer, scores.before));
+    if (text.Uses(Token::Accuracy))
+        values.Store(Token::Accuracy, ToChars(buffer, scores.accuracy));
+    if (text.Uses(Token::AfterCut))
+        values.Store(Token::AfterCut, ToChars(buffer, scores.after));
+    if (text.Uses(Token::Score))
+        values.Store(Token::Score, ToChars(buffer, scores.total));
+    // matching the six decimal places of std::to_string
+    if (text.Uses(Token::Percent))
+        values.Store(Token::Percent, ToChars(buffer, round(100 * (float) scores.total / scores.maxScore), 6));
+    if (text.Uses(Token::TimeDependency))
+        values.Store(Token::TimeDependency, TimeDependenceString(config, scores.timeDependence, buffer));
+    if (text.Uses(Token::BeforeCutSegment))
+        values.Set(Token::BeforeCutSegment, GetBestSegmentText(config.BeforeCutAngleSegments, scores.before));
+    if (text.Uses(Token::AccuracySegment))
+        values.Set(Token::AccuracySegment, GetBestSegmentText(config.AccuracySegments, scores.accuracy));
+    if (text.Uses(Token::AfterCutSegment))
+        values.Set(Token::AfterCutSegment, GetBestSegmentText(config.AfterCutAngleSegments, scores.after));
+    if (text.Uses(Token::TimeDependencySegment))
+        values.Set(Token::TimeDependencySegment, GetBestFloatSegmentText(config.TimeDependenceSegments, scores.timeDependence));
+    if (text.Uses(Token::Direction))
+        values.Set(Token::Direction, GetDirectionText(scores.wrongDirection));
+    if (text.Uses(Token::RollingAverage))
+        values.Store(Token::RollingAverage, ToChars(buffer, std::lround(context.stats.RollingAverage())));
+
+    context.text.clear();
+    text.Format(values, context.text);
+}
+
+static UnityEngine::Color GetJudgementColor(Judgement const& judgement, std::vector<Judgement> const& judgements, int score) {
+    if (!judgement.Fade || !judgement.Fade.value())
+        return judgement.Color.Color;
+    // get the lowest judgement with a higher threshold
+    Judgement const* best = nullptr;
+    for (auto& judgement : judgements) {
+        if (score < judgement.Threshold && (!best || judgement.Threshold < best->Threshold))
+            best = &judgement;
+    }
+    if (!best)
+        return judgement.Color.Color;
+    // thresholds can be anywhere in the range of an int, so the distance between them may not fit in one
+    double lowerThreshold = judgement.Threshold;
+    double higherThreshold = best->Threshold;
+    float lerpDistance = (score - lowerThreshold) / (higherThreshold - lowerThreshold);
+    auto lowerColor = judgement.Color.Color;
+    auto higherColor = best->Color.Color;
+    return UnityEngine::Color(
+        lowerColor.r + (higherColor.r - lowerColor.r) * lerpDistance,
+        lowerColor.g + (higherColor.g - lowerColor.g) * lerpDistance,
+        lowerColor.b + (higherColor.b - lowerColor.b) * lerpDistance,
+        lowerColor.a + (higherColor.a - lowerColor.a) * lerpDistance
+    );
+}
+
+JudgeResult HSV::JudgeCut(Config const& config, CutScores const& scores, JudgeContext& context) {
+    auto scoringType = scores.scoringType;
+
+    if (scoringType == ScoringType::ChainLink || scoringType == ScoringType::ChainLinkArcHead) {
+        auto& judgement = config.ChainLinkDisplay ? *config.ChainLinkDisplay : GetBestJudgement(config.Judgements, scores.total);
+
+        int16_t index = config.ChainLinkDisplay ? 0 : &judgement - config.Judgements.data();
+        if (scores.total >= 0 && scores.total < (int) config.ChainLinkTexts.size())
+            return {config.ChainLinkTexts[scores.total], judgement.Color.Color, index};
+        FormatJudgementText(config, judgement, scores, context);
+        return {context.text, judgement.Color.Color, index};
+    }
+
+    bool chainHead = scoringType == ScoringType::ChainHead || scoringType == ScoringType::ChainHeadArcTail;
+    auto& judgementVector = chainHead ? config.ChainHeadJudgements : config.Judgements;
+    auto& judgement = GetBestJudgement(judgementVector, scores.total);
+
+    FormatJudgementText(config, judgement, scores, context);
+    return {context.text, GetJudgementColor(judgement, judgementVector, scores.total), (int16_t) (&judgement - judgementVector.data())};
+}
+
+static int Random(std::default_random_engine& rng, int min, int max) {
+    return std::uniform_int_distribution<int>(min, max - 1)(rng);
+}
+
+template <class T>
+static T const* GetDisplay(std::vector<T> const& displays, int& counter, bool randomize, std::default_random_engine& rng) {
+    if (displays.empty())
+        return nullptr;
+    int idx = randomize ? Random(rng, 0, displays.size()) : (counter++ % displays.size());
+    return &displays[idx];
+}
+
+BadCutDisplay const* HSV::GetBadCutDisplay(Config const& config, BadCutType type, JudgeContext& context) {
+    bool randomize = config.RandomizeBadCutDisplays;
+    switch (type) {
+        case BadCutType::Bomb:
+            return GetDisplay(config.Bombs, context.bombsCounter, randomize, context.rng);
+        case BadCutType::WrongColor:
+            return GetDisplay(config.WrongColors, context.wrongColorsCounter, randomize, context.rng);
+        default:
+            return GetDisplay(config.WrongDirections, context.wrongDirectionsCounter, randomize, context.rng);
+    }
+}
+
+MissDisplay const* HSV::GetMissDisplay(Config const& config, JudgeContext& context) {
+    return GetDisplay(config.MissDisplays, context.missesCounter, config.RandomizeMissDisplays, context.rng);
+}
+
+std::pair<int16_t, UnityEngine::Color> HSV::GetUsedJudgement(Config const& config, CutScores const& scores) {
+    auto scoringType = scores.scoringType;
+    if ((scoringType == ScoringType::ChainLink || scoringType == ScoringType::ChainLinkArcHead) && config.ChainLinkDisplay)
+        return {0, config.ChainLinkDisplay->Color.Color};
+    bool chainHead = scoringType == ScoringType::ChainHead || scoringType == ScoringType::ChainHeadArcTail;
+    auto& judgementVector = chainHead && config.HasChainHead() ? config.ChainHeadJudgements : config.Judgements;
+    auto& judgement = GetBestJudgement(judgementVector, scores.total);
+    return {&judgement - judgementVector.data(), GetJudgementColor(judgement, judgementVector, scores.total)};
+}
+
+// chain links are always scored out of 20, and il2cpp isn't available yet when the config is first loaded
+static constexpr int ChainLinkMaxScore = 20;
+
+// strips tags that can't change what is displayed, returning the number of bytes removed
+static size_t OptimizeTexts(Config& config) {
+    size_t removed = 0;
+    auto optimizeFull = [&removed](std::string& text) {
+        size_t size = text.size();
+        RemoveEmptyTags(text);
+        RemoveTrailingClosingTags(text);
+        removed += size - text.size();
+    };
+    auto optimizeSegment = [&removed](std::string& text) {
+        size_t size = text.size();
+        RemoveEmptyTags(text);
+        removed += size - text.size();
+    };
+    // a segment that opens a noparse turns the tags after it in a template into text
+    bool noparseSegments = false;
+    for (auto segments : {&config.BeforeCutAngleSegments, &config.AccuracySegments, &config.AfterCutAngleSegments}) {
+        for (auto& segment : *segments) {
+            noparseSegments |= OpensNoparse(segment.Text);
+            optimizeSegment(segment.Text);
+        }
+    }
+    for (auto& segment : config.TimeDependenceSegments) {
+        noparseSegments |= OpensNoparse(segment.Text);
+        optimizeSegment(segment.Text);
+    }
+    if (!noparseSegments) {
+        for (auto& judgement : config.Judgements)
+            removed += OptimizeRichText(judgement.Text);
+        for (auto& judgement : config.ChainHeadJudgements)
+            removed += OptimizeRichText(judgement.Text);
+        if (config.ChainLinkDisplay)
+            removed += OptimizeRichText(config.ChainLinkDisplay->Text);
+    }
+    for (auto displays : {&config.WrongDirections, &config.WrongColors, &config.Bombs}) {
+        for (auto& display : *displays)
+            optimizeFull(display.Text);
+    }
+    for (auto& display : config.MissDisplays)
+        optimizeFull(display.Text);
+    return removed;
+}
+
+size_t HSV::PrepareForJudging(Config& config) {
+    using Token = TokenizedText::Token;
+
+    size_t removed = OptimizeTexts(config);
+    config.Glyphs = CollectGlyphs(config);
+
+    config.ChainLinkTexts.clear();
+    if (!config.ChainLinkDisplay)
+        return removed;
+    // a table by score only works when nothing else changes the text
+    auto& judgement = *config.ChainLinkDisplay;
+    for (auto token : judgement.Text.tokenTypes) {
+        if (token != Token::Literal && token != Token::Score && token != Token::Percent)
+            return removed;
+    }
+    // each score is formatted before it is in the table, so JudgeCut never looks it up
+    JudgeContext context;
+    for (int score = 0; score <= ChainLinkMaxScore; score++) {
+        auto result = JudgeCut(config, {.total = score, .maxScore = ChainLinkMaxScore, .scoringType = ScoringType::ChainLink}, context);
+        config.ChainLinkTexts.emplace_back(result.text);
+    }
+    return removed;
+}
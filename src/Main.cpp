@@ -1,22 +1,47 @@
 #include "Main.hpp"
 
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <future>
+
 #include "Config.hpp"
+#include "ConfigCache.hpp"
+#include "EventLog.hpp"
+#include "FadeCurve.hpp"
+#include "FixedDisplay.hpp"
+#include "FlatMap.hpp"
+#include "Glyphs.hpp"
 #include "GlobalNamespace/AudioTimeSyncController.hpp"
+#include "GlobalNamespace/BeatmapCharacteristicSO.hpp"
+#include "GlobalNamespace/BeatmapKey.hpp"
 #include "GlobalNamespace/BadNoteCutEffectSpawner.hpp"
 #include "GlobalNamespace/BeatmapObjectExecutionRating.hpp"
 #include "GlobalNamespace/EffectPoolsManualInstaller.hpp"
 #include "GlobalNamespace/FlyingScoreEffect.hpp"
 #include "GlobalNamespace/FlyingScoreSpawner.hpp"
 #include "GlobalNamespace/FlyingSpriteSpawner.hpp"
+#include "GlobalNamespace/GameplayCoreInstaller.hpp"
+#include "GlobalNamespace/GameplayCoreSceneSetupData.hpp"
 #include "GlobalNamespace/IReadonlyCutScoreBuffer.hpp"
+#include "GlobalNamespace/LevelCollectionNavigationController.hpp"
+#include "GlobalNamespace/LevelCompletionResults.hpp"
+#include "GlobalNamespace/LevelSelectionNavigationController.hpp"
 #include "GlobalNamespace/MissedNoteEffectSpawner.hpp"
 #include "GlobalNamespace/NoteData.hpp"
+#include "GlobalNamespace/ResultsViewController.hpp"
+#include "GlobalNamespace/StandardLevelDetailViewController.hpp"
+#include "GlobalNamespace/StandardLevelScenesTransitionSetupDataSO.hpp"
 #include "Settings.hpp"
+#include "Stream.hpp"
 #include "TMPro/TextMeshPro.hpp"
+#include "TMPro/TextMeshProUGUI.hpp"
 #include "UnityEngine/AnimationCurve.hpp"
+#include "UnityEngine/Resources.hpp"
 #include "UnityEngine/SpriteRenderer.hpp"
 #include "Zenject/DiContainer.hpp"
 #include "beatsaber-hook/shared/utils/hooking.hpp"
+#include "bsml/shared/BSML-Lite.hpp"
 #include "bsml/shared/BSML.hpp"
 #include "custom-types/shared/register.hpp"
 #include "json/DefaultConfig.hpp"
@@ -26,15 +51,87 @@
 static modloader::ModInfo modInfo = {MOD_ID, VERSION, 0};
 
 static GlobalNamespace::FlyingTextSpawner* textSpawner;
+static UnityW<TMPro::TMP_FontAsset> gameplayFont;
+// the font of the score effect prefab
+static constexpr char const* ScoreFontName = "Teko-Medium SDF";
+
+TMPro::TMP_FontAsset* GameplayFont() {
+    // set from the score effect prefab once a song has started, though the menus load the same font before that
+    if (!gameplayFont) {
+        gameplayFont = UnityEngine::Resources::FindObjectsOfTypeAll<TMPro::TMP_FontAsset*>()->FirstOrDefault([](auto x) {
+            return x->name == std::string(ScoreFontName);
+        });
+    }
+    return gameplayFont ? gameplayFont.ptr() : nullptr;
+}
 
 std::string ConfigsPath() {
     static std::string path = getDataDir(modInfo);
     return path;
 }
 
+std::string EventLogsPath() {
+    // kept out of the configs folder, since everything in there is listed as a config
+    static std::string path = [] {
+        std::string ret = ConfigsPath();
+        while (ret.ends_with('/'))
+            ret.pop_back();
+        return ret + "Logs/";
+    }();
+    return path;
+}
+
+std::string ValidationReportPath() {
+    return EventLogsPath() + "validation.tsv";
+}
+
+std::shared_ptr<HSV::Config const> GetDefaultConfig() {
+    static std::shared_ptr<HSV::Config const> const config = []() {
+        auto ret = std::make_shared<HSV::Config>(DefaultConfig());
+        PrepareConfig(*ret);
+        return ret;
+    }();
+    return config;
+}
+
+// which features have anything to do, so that hooks for the rest can pass straight through to the original
+static struct {
+    bool enabled = false;
+    bool chainHeads = false;
+    bool chainLinks = false;
+    bool badCuts = false;
+    bool misses = false;
+    bool logging = false;
+    bool streaming = false;
+} active;
+
+void UpdateActiveHooks() {
+    auto& config = *getGlobalConfig().CurrentConfig;
+    active.enabled = getGlobalConfig().ModEnabled.GetValue();
+    active.chainHeads = active.enabled && config.HasChainHead();
+    active.chainLinks = active.enabled && config.HasChainLink();
+    active.badCuts = active.enabled && !config.BadCutDisplays.empty();
+    active.misses = active.enabled && !config.MissDisplays.empty();
+    active.logging = active.enabled && getGlobalConfig().LogJudgements.GetValue();
+    active.streaming = active.enabled && getGlobalConfig().StreamJudgements.GetValue();
+    HSV::UpdateStreamServer(active.streaming, getGlobalConfig().StreamPort.GetValue());
+}
+
+// switches to a config, either from the cache or loaded now, returning false if it could not be loaded
+static bool UseConfig(std::string const& path) {
+    try {
+        getGlobalConfig().CurrentConfig = path.empty() ? GetDefaultConfig() : HSV::LoadConfig(path);
+    } catch (std::exception const& err) {
+        logger.error("Could not load config file {}: {}", path, err.what());
+        return false;
+    }
+    UpdateActiveHooks();
+    return true;
+}
+
 static void SetDefaultConfig() {
     getGlobalConfig().SelectedConfig.SetValue("");
-    getGlobalConfig().CurrentConfig = defaultConfig;
+    UseConfig("");
 }
 
 void LoadCurrentConfig() {
@@ -44,27 +141,188 @@ void LoadCurrentConfig() {
         SetDefaultConfig();
         return;
     }
-    try {
-        ReadFromFile(selected, getGlobalConfig().CurrentConfig);
-    } catch (std::exception const& err) {
-        logger.error("Could not load config file {}: {}", selected, err.what());
+    if (!UseConfig(selected))
         SetDefaultConfig();
+}
+
+static float MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// the selected config, loaded on another thread during startup, or null if it couldn't be
+static std::future<std::shared_ptr<HSV::Config const>> startupConfig;
+
+static std::shared_ptr<HSV::Config const> LoadStartupConfig(std::string selected) {
+    auto start = std::chrono::steady_clock::now();
+    if (!direxists(ConfigsPath()))
+        mkpath(ConfigsPath());
+    std::shared_ptr<HSV::Config const> ret;
+    if (selected.empty())
+        ret = GetDefaultConfig();
+    else if (!fileexists(selected))
+        logger.warn("Could not find selected config! Using the default");
+    else {
+        try {
+            ret = HSV::LoadConfig(selected);
+        } catch (std::exception const& err) {
+            logger.error("Could not load config file {}: {}", selected, err.what());
+        }
+    }
+    logger.info("Loaded config in background in {:.1f} ms", MillisecondsSince(start));
+    return ret;
+}
+
+void FinishConfigLoad() {
+    if (!startupConfig.valid())
+        return;
+    auto start = std::chrono::steady_clock::now();
+    auto config = startupConfig.get();
+    logger.info("Waited {:.1f} ms for config to load", MillisecondsSince(start));
+    if (!config) {
+        SetDefaultConfig();
+        return;
     }
+    getGlobalConfig().CurrentConfig = std::move(config);
+    UpdateActiveHooks();
 }
 
-// used for fixed position
+// the config in use for the current or last level, kept for its results after the selected config is restored
+static std::shared_ptr<HSV::Config const> levelConfig;
+// whether a profile replaced the selected config for the current level
+static bool usingProfile = false;
+
+static std::string ProfilePath(ConfigProfile const& profile) {
+    return (std::filesystem::path(ConfigsPath()) / profile.Config).string();
+}
+
+static void PreloadProfiles() {
+    std::vector<std::string> paths;
+    for (auto& profile : getGlobalConfig().Profiles.GetValue())
+        paths.emplace_back(ProfilePath(profile));
+    if (!paths.empty())
+        HSV::PreloadConfigs(std::move(paths));
+}
+
+// the profile with the most fields matching the level, ignoring any with a field that doesn't match
+static std::optional<ConfigProfile>
+FindProfile(std::vector<ConfigProfile> const& profiles, std::string_view levelId, std::string_view characteristic, std::string_view difficulty) {
+    std::optional<ConfigProfile> best;
+    int bestMatches = -1;
+    for (auto& profile : profiles) {
+        int matches = 0;
+        bool valid = true;
+        auto check = [&](std::optional<std::string> const& field, std::string_view value) {
+            if (field && *field == value)
+                matches++;
+            else if (field)
+                valid = false;
+        };
+        check(profile.LevelId, levelId);
+        check(profile.Characteristic, characteristic);
+        check(profile.Difficulty, difficulty);
+        if (valid && matches > bestMatches) {
+            best = profile;
+            bestMatches = matches;
+        }
+    }
+    return best;
+}
+
+static std::string_view DifficultyName(GlobalNamespace::BeatmapDifficulty difficulty) {
+    static constexpr std::string_view names[] = {"Easy", "Normal", "Hard", "Expert", "ExpertPlus"};
+    int idx = (int) difficulty;
+    return idx >= 0 && idx < (int) std::size(names) ? names[idx] : "";
+}
+
+// what profiles are matched against for a level
+struct LevelNames {
+    std::string levelId;
+    std::string characteristic;
+    std::string_view difficulty;
+};
+
+static LevelNames GetLevelNames(GlobalNamespace::BeatmapKey const& key) {
+    return {
+        static_cast<std::string>(key.levelId),
+        static_cast<std::string>(key.beatmapCharacteristic->serializedName),
+        DifficultyName(key.difficulty),
+    };
+}
+
+static void UseLevelConfig(GlobalNamespace::BeatmapKey const& key) {
+    auto profiles = getGlobalConfig().Profiles.GetValue();
+    if (profiles.empty())
+        return;
+    auto [levelId, characteristic, difficulty] = GetLevelNames(key);
+    auto profile = FindProfile(profiles, levelId, characteristic, difficulty);
+    usingProfile = profile && UseConfig(ProfilePath(*profile));
+    if (usingProfile) {
+        logger.info("Using config {} for {} {} {}", profile->Config, levelId, characteristic, difficulty);
+        return;
+    }
+    LoadCurrentConfig();
+}
+
+// loads the config of a level in the background while it is selected, so starting it doesn't wait on the file
+static void PreloadLevelConfig(GlobalNamespace::BeatmapKey const& key) {
+    if (!getGlobalConfig().ModEnabled.GetValue() || !key.IsValid())
+        return;
+    auto profiles = getGlobalConfig().Profiles.GetValue();
+    if (profiles.empty())
+        return;
+    auto [levelId, characteristic, difficulty] = GetLevelNames(key);
+    if (auto profile = FindProfile(profiles, levelId, characteristic, difficulty))
+        HSV::PreloadSpeculative({ProfilePath(*profile)});
+}
+
+// used for fixed position when a pooled effect is still shown
 GlobalNamespace::FlyingScoreEffect* currentEffect = nullptr;
 // used for updating ratings
-std::unordered_map<GlobalNamespace::CutScoreBuffer*, GlobalNamespace::FlyingScoreEffect*> swingRatingMap = {};
+HSV::FlatMap<GlobalNamespace::CutScoreBuffer*, GlobalNamespace::FlyingScoreEffect*> swingRatingMap = {};
+
+// sampled from the prefab once per scene, and shared by every score effect
+static HSV::FadeCurve scoreFade;
+// the alpha last pushed to the text of each judged effect, from 0 to 255, or -1 after its color was replaced
+static HSV::FlatMap<GlobalNamespace::FlyingScoreEffect*, int> fadingEffects;
+
+static std::optional<JudgedCut> JudgeEffect(
+    GlobalNamespace::CutScoreBuffer* cutScoreBuffer,
+    GlobalNamespace::FlyingScoreEffect* flyingScoreEffect,
+    GlobalNamespace::NoteCutInfo const& noteCutInfo
+) {
+    auto judged = Judge(cutScoreBuffer, flyingScoreEffect, noteCutInfo);
+    fadingEffects.insert_or_assign(flyingScoreEffect, -1);
+    return judged;
+}
+
+// matching the duration the game uses for score effects
+static constexpr float ScoreEffectDuration = 0.7;
+
+// whether notes of the current song are being recorded, for the stats and any logging or streaming
+static bool recording = false;
+
+static std::string NewEventLogPath() {
+    auto time = std::time(nullptr);
+    char name[32];
+    std::strftime(name, sizeof(name), "%Y-%m-%d_%H-%M-%S", std::localtime(&time));
+    return fmt::format("{}{}.hsvl", EventLogsPath(), name);
+}
+
+// only created when the config has a fixed position, replacing pooled score effects for judged cuts
+static HSV::FixedDisplay* fixedDisplay = nullptr;
+// the cut currently shown on the fixed display
+static GlobalNamespace::CutScoreBuffer* fixedOwner = nullptr;
+// cuts destined for the fixed display that are still being rated
+static HSV::FlatMap<GlobalNamespace::CutScoreBuffer*, bool> fixedPending;
 
 static bool SkipJudge(GlobalNamespace::NoteCutInfo const& cutInfo) {
     using ScoringType = GlobalNamespace::NoteData::ScoringType;
 
     auto cutType = cutInfo.noteData->scoringType;
     if (cutType == ScoringType::ChainHead || cutType == ScoringType::ChainHeadArcTail)
-        return !getGlobalConfig().CurrentConfig.HasChainHead();
+        return !active.chainHeads;
     if (cutType == ScoringType::ChainLink || cutType == ScoringType::ChainLinkArcHead)
-        return !getGlobalConfig().CurrentConfig.HasChainLink();
+        return !active.chainLinks;
     return false;
 }
 
@@ -78,10 +336,10 @@ MAKE_HOOK_MATCH(
     UnityEngine::Vector3 targetPos,
     UnityEngine::Color color
 ) {
-    bool enabled = getGlobalConfig().ModEnabled.GetValue();
+    bool enabled = active.enabled;
 
     if (enabled) {
-        auto& config = getGlobalConfig().CurrentConfig;
+        auto& config = *getGlobalConfig().CurrentConfig;
         if (config.FixedPos) {
             targetPos = config.FixedPos.value();
             self->transform->position = targetPos;
@@ -105,18 +363,53 @@ MAKE_HOOK_MATCH(
             logger.error("CutScoreBuffer is not GlobalNamespace::CutScoreBuffer!");
             return;
         }
-        if (SkipJudge(cast->noteCutInfo))
+        // buffers without swing ratings, like chain links, are finished immediately and never report it
+        bool finished = cast->isFinished;
+        if (SkipJudge(cast->noteCutInfo)) {
+            if (recording && finished)
+                RecordCut(cast, std::nullopt);
             return;
+        }
 
-        if (!cast->isFinished)
-            swingRatingMap.insert({cast, self});
+        if (!finished)
+            swingRatingMap.insert_or_assign(cast, self);
 
         self->_maxCutDistanceScoreIndicator->enabled = false;
         self->_text->richText = true;
         self->_text->enableWordWrapping = false;
         self->_text->overflowMode = TMPro::TextOverflowModes::Overflow;
 
-        Judge(cast, self, cast->noteCutInfo);
+        auto judged = JudgeEffect(cast, self, cast->noteCutInfo);
+        if (recording && finished)
+            RecordCut(cast, judged);
+    }
+}
+
+MAKE_HOOK_MATCH(
+    FlyingScoreSpawner_SpawnFlyingScore,
+    &GlobalNamespace::FlyingScoreSpawner::SpawnFlyingScore,
+    void,
+    GlobalNamespace::FlyingScoreSpawner* self,
+    GlobalNamespace::IReadonlyCutScoreBuffer* cutScoreBuffer,
+    UnityEngine::Color color
+) {
+    // cuts shown on pooled effects are judged and recorded in FlyingScoreEffect_InitAndPresent
+    if (!active.enabled || !fixedDisplay)
+        return FlyingScoreSpawner_SpawnFlyingScore(self, cutScoreBuffer, color);
+
+    auto cast = il2cpp_utils::try_cast<GlobalNamespace::CutScoreBuffer>(cutScoreBuffer).value_or(nullptr);
+    if (!cast || SkipJudge(cast->noteCutInfo))
+        return FlyingScoreSpawner_SpawnFlyingScore(self, cutScoreBuffer, color);
+
+    // no pooled effect at all, just retarget the fixed display
+    if (!cast->isFinished)
+        fixedPending.insert_or_assign(cast, true);
+    if (cast->isFinished || !getGlobalConfig().HideUntilDone.GetValue()) {
+        fixedOwner = cast;
+        auto judged = JudgeFixed(cast, fixedDisplay, true);
+        // buffers without swing ratings, like chain links, are finished immediately and never report it
+        if (recording && cast->isFinished)
+            RecordCut(cast, judged);
     }
 }
 
@@ -130,7 +423,13 @@ MAKE_HOOK_MATCH(
 ) {
     CutScoreBuffer_HandleSaberSwingRatingCounterDidChange(self, swingRatingCounter, rating);
 
-    if (getGlobalConfig().ModEnabled.GetValue()) {
+    if (active.enabled) {
+        if (fixedPending.contains(self)) {
+            // the rating changes every frame of the swing, which shouldn't restart the fade each time
+            if (fixedOwner == self)
+                JudgeFixed(self, fixedDisplay, false);
+            return;
+        }
         if (SkipJudge(self->noteCutInfo))
             return;
 
@@ -139,7 +438,7 @@ MAKE_HOOK_MATCH(
             return;
         auto flyingScoreEffect = itr->second;
 
-        Judge(self, flyingScoreEffect, self->noteCutInfo);
+        JudgeEffect(self, flyingScoreEffect, self->noteCutInfo);
     }
 }
 
@@ -152,24 +451,32 @@ MAKE_HOOK_MATCH(
 ) {
     CutScoreBuffer_HandleSaberSwingRatingCounterDidFinish(self, swingRatingCounter);
 
-    if (getGlobalConfig().ModEnabled.GetValue()) {
-        if (SkipJudge(self->noteCutInfo))
-            return;
-
-        auto itr = swingRatingMap.find(self);
-        if (itr == swingRatingMap.end())
-            return;
-        auto flyingScoreEffect = itr->second;
-        swingRatingMap.erase(itr);
-
-        Judge(self, flyingScoreEffect, self->noteCutInfo);
-
-        if (getGlobalConfig().CurrentConfig.FixedPos && getGlobalConfig().HideUntilDone.GetValue()) {
-            if (currentEffect)
-                currentEffect->gameObject->active = false;
-            currentEffect = flyingScoreEffect;
+    // recorded with the final judgement if it is shown, after judging it
+    std::optional<JudgedCut> judged;
+    if (active.enabled) {
+        if (fixedPending.erase(self)) {
+            // hidden until now, so it takes over the display
+            bool newCut = getGlobalConfig().HideUntilDone.GetValue();
+            if (newCut)
+                fixedOwner = self;
+            if (fixedOwner == self)
+                judged = JudgeFixed(self, fixedDisplay, newCut);
+        } else if (auto itr = swingRatingMap.find(self); itr != swingRatingMap.end() && !SkipJudge(self->noteCutInfo)) {
+            auto flyingScoreEffect = itr->second;
+            swingRatingMap.erase(itr);
+
+            judged = JudgeEffect(self, flyingScoreEffect, self->noteCutInfo);
+
+            if (getGlobalConfig().CurrentConfig->FixedPos && getGlobalConfig().HideUntilDone.GetValue()) {
+                if (currentEffect)
+                    currentEffect->gameObject->active = false;
+                currentEffect = flyingScoreEffect;
+            }
         }
     }
+
+    if (recording)
+        RecordCut(self, judged);
 }
 
 MAKE_HOOK_MATCH(
@@ -179,6 +486,7 @@ MAKE_HOOK_MATCH(
     GlobalNamespace::FlyingScoreSpawner* self,
     GlobalNamespace::FlyingObjectEffect* effect
 ) {
+    fadingEffects.erase((GlobalNamespace::FlyingScoreEffect*) effect);
     if (currentEffect == (GlobalNamespace::FlyingScoreEffect*) effect) {
         currentEffect->gameObject->active = false;
         currentEffect = nullptr;
@@ -189,12 +497,76 @@ MAKE_HOOK_MATCH(
 MAKE_HOOK_MATCH(
     FlyingScoreEffect_ManualUpdate, &GlobalNamespace::FlyingScoreEffect::ManualUpdate, void, GlobalNamespace::FlyingScoreEffect* self, float t
 ) {
-    FlyingScoreEffect_ManualUpdate(self, t);
+    if (!active.enabled)
+        return FlyingScoreEffect_ManualUpdate(self, t);
 
-    if (getGlobalConfig().ModEnabled.GetValue()) {
+    auto itr = fadingEffects.find(self);
+    if (itr == fadingEffects.end() || !scoreFade) {
+        FlyingScoreEffect_ManualUpdate(self, t);
         self->_color.a = self->_fadeAnimationCurve->Evaluate(t);
         self->_text->color = self->_color;
+        return;
+    }
+    // the original only sets colors, which are entirely replaced here for judged effects
+    float alpha = scoreFade.Evaluate(t);
+    int quantized = std::lround(std::clamp(alpha, 0.0f, 1.0f) * 255);
+    if (quantized == itr->second)
+        return;
+    itr->second = quantized;
+    self->_color.a = alpha;
+    self->_text->color = self->_color;
+}
+
+// before the effect pools are installed, so that everything set up for the level uses its config
+MAKE_HOOK_MATCH(GameplayCoreInstaller_InstallBindings, &GlobalNamespace::GameplayCoreInstaller::InstallBindings, void, GlobalNamespace::GameplayCoreInstaller* self) {
+    FinishConfigLoad();
+
+    if (getGlobalConfig().ModEnabled.GetValue())
+        UseLevelConfig(self->_sceneSetupData->beatmapKey);
+    levelConfig = getGlobalConfig().CurrentConfig;
+
+    GameplayCoreInstaller_InstallBindings(self);
+}
+
+// however the level ended, so the menus show the selected config again instead of the level's profile
+MAKE_HOOK_MATCH(
+    StandardLevelScenesTransitionSetupDataSO_Finish,
+    &GlobalNamespace::StandardLevelScenesTransitionSetupDataSO::Finish,
+    void,
+    GlobalNamespace::StandardLevelScenesTransitionSetupDataSO* self,
+    GlobalNamespace::LevelCompletionResults* levelCompletionResults
+) {
+    if (usingProfile) {
+        usingProfile = false;
+        LoadCurrentConfig();
     }
+
+    StandardLevelScenesTransitionSetupDataSO_Finish(self, levelCompletionResults);
+}
+
+MAKE_HOOK_MATCH(
+    LevelSelectionNavigationController_HandleLevelCollectionNavigationControllerDidChangeLevelDetailContent,
+    &GlobalNamespace::LevelSelectionNavigationController::HandleLevelCollectionNavigationControllerDidChangeLevelDetailContent,
+    void,
+    GlobalNamespace::LevelSelectionNavigationController* self,
+    GlobalNamespace::LevelCollectionNavigationController* viewController,
+    GlobalNamespace::StandardLevelDetailViewController::ContentType contentType
+) {
+    LevelSelectionNavigationController_HandleLevelCollectionNavigationControllerDidChangeLevelDetailContent(self, viewController, contentType);
+
+    PreloadLevelConfig(self->beatmapKey);
+}
+
+MAKE_HOOK_MATCH(
+    LevelSelectionNavigationController_HandleLevelCollectionNavigationControllerDidChangeDifficultyBeatmap,
+    &GlobalNamespace::LevelSelectionNavigationController::HandleLevelCollectionNavigationControllerDidChangeDifficultyBeatmap,
+    void,
+    GlobalNamespace::LevelSelectionNavigationController* self,
+    GlobalNamespace::LevelCollectionNavigationController* viewController
+) {
+    LevelSelectionNavigationController_HandleLevelCollectionNavigationControllerDidChangeDifficultyBeatmap(self, viewController);
+
+    PreloadLevelConfig(self->beatmapKey);
 }
 
 MAKE_HOOK_MATCH(
@@ -207,6 +579,37 @@ MAKE_HOOK_MATCH(
 ) {
     EffectPoolsManualInstaller_ManualInstallBindings(self, container, shortBeatEffect);
 
+    // normally already done by GameplayCoreInstaller, but just in case of any other scene setup
+    FinishConfigLoad();
+
+    scoreFade = HSV::FadeCurve(self->_flyingScoreEffectPrefab->_fadeAnimationCurve);
+    fadingEffects.clear();
+
+    fixedOwner = nullptr;
+    fixedPending.clear();
+    auto& config = *getGlobalConfig().CurrentConfig;
+
+    recording = active.enabled;
+    ResetStats();
+    if (active.logging) {
+        if (!direxists(EventLogsPath()))
+            mkpath(EventLogsPath());
+        HSV::BeginEventLog(NewEventLogPath());
+    }
+
+    gameplayFont = self->_flyingScoreEffectPrefab->_text->font;
+    // avoid stalls from dynamic atlases adding glyphs in the middle of the song
+    if (active.enabled) {
+        auto missing = HSV::PopulateGlyphs(gameplayFont, config.Glyphs);
+        if (!missing.empty())
+            logger.warn("Config uses characters missing from the font: {}", HSV::GlyphsToString(missing));
+    }
+    if (active.enabled && config.FixedPos) {
+        fixedDisplay = container->InstantiateComponentOnNewGameObject<HSV::FixedDisplay*>("HSVFixedScoreDisplay");
+        fixedDisplay->Init(self->_flyingScoreEffectPrefab->_text, scoreFade, *config.FixedPos, ScoreEffectDuration);
+        MetaCore::Engine::SetOnDestroy(fixedDisplay, []() { fixedDisplay = nullptr; });
+    }
+
     // use zenject to populate the text effect pool
     textSpawner = container->InstantiateComponentOnNewGameObject<GlobalNamespace::FlyingTextSpawner*>("HSVFlyingTextSpawner");
     textSpawner->_duration = 0.7;
@@ -215,7 +618,11 @@ MAKE_HOOK_MATCH(
     textSpawner->_targetZPos = 14;
     textSpawner->_shake = false;
     textSpawner->_fontSize = 4.5;
-    MetaCore::Engine::SetOnDestroy(textSpawner, []() { textSpawner = nullptr; });
+    MetaCore::Engine::SetOnDestroy(textSpawner, []() {
+        textSpawner = nullptr;
+        HSV::EndEventLog();
+        recording = false;
+    });
     logger.debug("created text spawner");
 }
 
@@ -227,6 +634,10 @@ MAKE_HOOK_MATCH(
     GlobalNamespace::NoteController* noteController,
     ByRef<GlobalNamespace::NoteCutInfo> noteCutInfo
 ) {
+    if (recording && !noteCutInfo->allIsOK)
+        RecordBadCut(noteCutInfo.heldRef);
+    if (!active.badCuts)
+        return BadNoteCutEffectSpawner_HandleNoteWasCut(self, noteController, noteCutInfo);
     if (noteController->noteData->time + 0.5 < self->_audioTimeSyncController->songTime)
         return;
     if (noteCutInfo->allIsOK || !SpawnBadCut(textSpawner, noteCutInfo.heldRef))
@@ -240,6 +651,10 @@ MAKE_HOOK_MATCH(
     GlobalNamespace::MissedNoteEffectSpawner* self,
     GlobalNamespace::NoteController* noteController
 ) {
+    if (recording && noteController->noteData->colorType != GlobalNamespace::ColorType::None)
+        RecordMiss(noteController);
+    if (!active.misses)
+        return MissedNoteEffectSpawner_HandleNoteWasMissed(self, noteController);
     if (noteController->hidden || noteController->noteData->time + 0.5 < self->_audioTimeSyncController->songTime ||
         noteController->noteData->colorType == GlobalNamespace::ColorType::None)
         return;
@@ -247,19 +662,51 @@ MAKE_HOOK_MATCH(
         MissedNoteEffectSpawner_HandleNoteWasMissed(self, noteController);
 }
 
+// created on the results screen the first time it is needed
+static TMPro::TextMeshProUGUI* statsText = nullptr;
+
+MAKE_HOOK_MATCH(
+    ResultsViewController_DidActivate,
+    &GlobalNamespace::ResultsViewController::DidActivate,
+    void,
+    GlobalNamespace::ResultsViewController* self,
+    bool firstActivation,
+    bool addedToHierarchy,
+    bool screenSystemEnabling
+) {
+    ResultsViewController_DidActivate(self, firstActivation, addedToHierarchy, screenSystemEnabling);
+
+    bool show = active.enabled && getGlobalConfig().ShowStats.GetValue();
+    if (!statsText && show) {
+        statsText = BSML::Lite::CreateText(self->transform, "");
+        statsText->fontSize = 2.5;
+        statsText->enableWordWrapping = false;
+        statsText->alignment = TMPro::TextAlignmentOptions::Top;
+        statsText->rectTransform->anchoredPosition = {0, -38};
+        statsText->rectTransform->sizeDelta = {110, 30};
+        MetaCore::Engine::SetOnDestroy(statsText, []() { statsText = nullptr; });
+    }
+    if (!statsText)
+        return;
+    statsText->gameObject->active = show;
+    if (show)
+        statsText->text = HSV::StatsSummary(GetStats(), levelConfig ? *levelConfig : *getGlobalConfig().CurrentConfig);
+}
+
 extern "C" void setup(CModInfo* info) {
+    auto start = std::chrono::steady_clock::now();
     *info = modInfo.to_c();
 
     Paper::Logger::RegisterFileContextId(MOD_ID);
 
     getGlobalConfig().Init(modInfo);
+    HSV::SetConfigCacheBudget(std::max(getGlobalConfig().ConfigCacheBytes.GetValue(), 0));
 
-    if (!direxists(ConfigsPath()))
-        mkpath(ConfigsPath());
-
-    LoadCurrentConfig();
+    // nothing needs the config until the settings are opened or a level starts, where FinishConfigLoad waits for it
+    startupConfig = std::async(std::launch::async, LoadStartupConfig, getGlobalConfig().SelectedConfig.GetValue());
+    PreloadProfiles();
 
-    logger.info("Completed setup!");
+    logger.info("Completed setup in {:.1f} ms!", MillisecondsSince(start));
 }
 
 extern "C" void late_load() {
@@ -272,12 +719,18 @@ extern "C" void late_load() {
 
     logger.info("Installing hooks...");
     INSTALL_HOOK(logger, FlyingScoreEffect_InitAndPresent);
+    INSTALL_HOOK(logger, FlyingScoreSpawner_SpawnFlyingScore);
     INSTALL_HOOK(logger, CutScoreBuffer_HandleSaberSwingRatingCounterDidChange);
     INSTALL_HOOK(logger, CutScoreBuffer_HandleSaberSwingRatingCounterDidFinish);
     INSTALL_HOOK(logger, FlyingScoreSpawner_HandleFlyingObjectEffectDidFinish);
     INSTALL_HOOK(logger, FlyingScoreEffect_ManualUpdate);
+    INSTALL_HOOK(logger, GameplayCoreInstaller_InstallBindings);
+    INSTALL_HOOK(logger, StandardLevelScenesTransitionSetupDataSO_Finish);
+    INSTALL_HOOK(logger, LevelSelectionNavigationController_HandleLevelCollectionNavigationControllerDidChangeLevelDetailContent);
+    INSTALL_HOOK(logger, LevelSelectionNavigationController_HandleLevelCollectionNavigationControllerDidChangeDifficultyBeatmap);
     INSTALL_HOOK(logger, EffectPoolsManualInstaller_ManualInstallBindings);
     INSTALL_HOOK(logger, BadNoteCutEffectSpawner_HandleNoteWasCut);
     INSTALL_HOOK(logger, MissedNoteEffectSpawner_HandleNoteWasMissed);
+    INSTALL_HOOK(logger, ResultsViewController_DidActivate);
     logger.info("Installed all hooks!");
 }
@@ -0,0 +1,171 @@
+#include "RichText.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+using namespace HSV;
+
+// tags that only change the text inside them, so an empty pair displays nothing and affects nothing
+static constexpr std::array<std::string_view, 17> ScopedTags = {
+    "b", "i", "u", "s", "color", "size", "font", "font-weight", "mark", "sub", "sup", "smallcaps", "lowercase", "uppercase", "allcaps", "cspace", "voffset",
+};
+
+static constexpr std::string_view NoparseClose = "</noparse>";
+
+static std::string Lowercase(std::string_view str) {
+    std::string ret(str);
+    std::transform(ret.begin(), ret.end(), ret.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ret;
+}
+
+// the lowercase name of the tag from start to end, including the / of closing tags
+static std::string TagName(std::string_view text, size_t start, size_t end) {
+    auto tag = text.substr(start + 1, end - start - 1);
+    return Lowercase(tag.substr(0, tag.find_first_of("= ")));
+}
+
+static bool IsScoped(std::string_view name) {
+    return std::find(ScopedTags.begin(), ScopedTags.end(), name) != ScopedTags.end();
+}
+
+// the > ending the tag that starts at start, or npos when another < comes first, which starts a tag of its own instead
+static size_t TagEnd(std::string_view text, size_t start) {
+    size_t end = text.find_first_of("<>", start + 1);
+    return end != std::string::npos && text[end] == '>' ? end : std::string::npos;
+}
+
+// the position just after the </noparse> ending a region that is open at pos, or npos if it is never closed
+static size_t NoparseEnd(std::string_view text, size_t pos) {
+    size_t end = Lowercase(text).find(NoparseClose, pos);
+    return end == std::string::npos ? end : end + NoparseClose.size();
+}
+
+// whether the text from start on leaves a <noparse> open, displaying everything after it as is
+static bool EndsInNoparse(std::string_view text, size_t start) {
+    while ((start = text.find('<', start)) != std::string::npos) {
+        size_t end = TagEnd(text, start);
+        if (end == std::string::npos) {
+            start++;
+            continue;
+        }
+        if (TagName(text, start, end) == "noparse") {
+            start = NoparseEnd(text, end + 1);
+            if (start == std::string::npos)
+                return true;
+        } else
+            start = end + 1;
+    }
+    return false;
+}
+
+static void RemoveEmptyTagsFrom(std::string& text, size_t start) {
+    while ((start = text.find('<', start)) != std::string::npos) {
+        size_t end = TagEnd(text, start);
+        if (end == std::string::npos) {
+            start++;
+            continue;
+        }
+        std::string name = TagName(text, start, end);
+        // tags inside noparse are displayed as text
+        if (name == "noparse") {
+            start = NoparseEnd(text, end + 1);
+            if (start == std::string::npos)
+                return;
+            continue;
+        }
+        std::string close = "</" + name + ">";
+        // a stray < before the pair could join with what comes after it into a new tag
+        size_t stray = start == 0 ? std::string::npos : text.find_last_of("<>", start - 1);
+        bool joins = stray != std::string::npos && text[stray] == '<';
+        if (!joins && IsScoped(name) && Lowercase(std::string_view(text).substr(end + 1, close.size())) == close) {
+            text.erase(start, end + 1 + close.size() - start);
+            // the removal may have left an enclosing pair empty
+            start = start == 0 ? 0 : text.rfind('<', start - 1);
+            if (start == std::string::npos)
+                start = 0;
+        } else
+            start = end + 1;
+    }
+}
+
+static void RemoveTrailingClosingTagsFrom(std::string& text, size_t start) {
+    if (EndsInNoparse(text, start))
+        return;
+    while (!text.empty() && text.back() == '>') {
+        size_t tag = text.rfind('<');
+        if (tag == std::string::npos || tag < start)
+            return;
+        // anything else, like </3> or </noparse>, may well be displayed
+        std::string name = TagName(text, tag, text.size() - 1);
+        if (!name.starts_with('/') || !IsScoped(std::string_view(name).substr(1)))
+            return;
+        text.erase(tag);
+    }
+}
+
+void HSV::RemoveEmptyTags(std::string& text) {
+    RemoveEmptyTagsFrom(text, 0);
+}
+
+void HSV::RemoveTrailingClosingTags(std::string& text) {
+    RemoveTrailingClosingTagsFrom(text, 0);
+}
+
+bool HSV::OpensNoparse(std::string_view text) {
+    return EndsInNoparse(text, 0);
+}
+
+std::string HSV::ClosingTags(std::string_view text) {
+    std::vector<std::string> open;
+    size_t start = 0;
+    while ((start = text.find('<', start)) != std::string::npos) {
+        size_t end = TagEnd(text, start);
+        if (end == std::string::npos) {
+            start++;
+            continue;
+        }
+        std::string name = TagName(text, start, end);
+        if (name == "noparse") {
+            start = NoparseEnd(text, end + 1);
+            // nothing after it is parsed, so it is the innermost
+            if (start == std::string::npos) {
+                open.push_back(name);
+                break;
+            }
+            continue;
+        }
+        // a closing tag ends the latest of its kind, wherever that is
+        if (name.starts_with('/')) {
+            auto found = std::find(open.rbegin(), open.rend(), std::string_view(name).substr(1));
+            if (found != open.rend())
+                open.erase(std::next(found).base());
+        } else if (IsScoped(name))
+            open.push_back(name);
+        start = end + 1;
+    }
+    std::string ret;
+    for (auto name = open.rbegin(); name != open.rend(); name++)
+        ret += "</" + *name + ">";
+    return ret;
+}
+
+size_t HSV::OptimizeRichText(TokenizedText& text) {
+    size_t removed = 0;
+    bool noparse = false;
+    text.TransformLiterals([&removed, &noparse](std::string& literal, bool isLast) {
+        size_t size = literal.size();
+        // a noparse opened by an earlier literal continues into this one until it is closed
+        size_t start = noparse ? NoparseEnd(literal, 0) : 0;
+        if (start == std::string::npos)
+            return;
+        RemoveEmptyTagsFrom(literal, start);
+        if (isLast)
+            RemoveTrailingClosingTagsFrom(literal, start);
+        noparse = EndsInNoparse(literal, start);
+        removed += size - literal.size();
+    });
+    return removed;
+}
@@ -1,10 +1,21 @@
 #include "Settings.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 #include "Config.hpp"
+#include "ConfigCache.hpp"
+#include "Glyphs.hpp"
+#include "HMUI/SelectableCell.hpp"
 #include "HMUI/Touchable.hpp"
+#include "Judgments.hpp"
 #include "Main.hpp"
+#include "RichText.hpp"
+#include "System/Action_2.hpp"
 #include "UnityEngine/Resources.hpp"
+#include "Validation.hpp"
 #include "bsml/shared/BSML-Lite.hpp"
+#include "custom-types/shared/delegate.hpp"
 
 DEFINE_TYPE(HSV, CustomList);
 DEFINE_TYPE(HSV, SettingsViewController);
@@ -17,28 +28,83 @@ void CustomList::ctor() {
     reuseIdentifier = "HSVConfigListTableCell";
     cellSize = 8;
     tableView = nullptr;
+    simpleTextTableCellInstance = nullptr;
+}
+
+void CustomList::Clear() {
+    names.clear();
+    nameRanges.clear();
+    failures.clear();
+    hints.clear();
+}
+
+void CustomList::Add(std::string_view name) {
+    nameRanges.emplace_back(names.size(), name.size());
+    names.append(name);
+}
+
+void CustomList::AddFailure(std::string_view name, std::string error) {
+    failures.emplace_back(nameRanges.size(), std::move(error));
+    Add(name);
+}
+
+void CustomList::AddWithHint(std::string_view name, std::string hint) {
+    hints.emplace_back(nameRanges.size(), std::move(hint));
+    Add(name);
+}
+
+std::string_view CustomList::GetName(int idx) const {
+    auto [offset, length] = nameRanges[idx];
+    return std::string_view(names).substr(offset, length);
+}
+
+static std::string const* FindByIdx(std::vector<std::pair<int, std::string>> const& entries, int idx) {
+    auto itr = std::lower_bound(entries.begin(), entries.end(), idx, [](auto const& entry, int idx) { return entry.first < idx; });
+    if (itr == entries.end() || itr->first != idx)
+        return nullptr;
+    return &itr->second;
+}
+
+std::string const* CustomList::GetFailure(int idx) const {
+    return FindByIdx(failures, idx);
+}
+
+std::string const* CustomList::GetHint(int idx) const {
+    return FindByIdx(hints, idx);
 }
 
 HMUI::TableCell* CustomList::CellForIdx(HMUI::TableView* tableView, int idx) {
     auto tableCell = (GlobalNamespace::SimpleTextTableCell*) tableView->DequeueReusableCellForIdentifier(reuseIdentifier).unsafePtr();
     if (!tableCell) {
-        auto simpleTextTableCellInstance = UnityEngine::Resources::FindObjectsOfTypeAll<GlobalNamespace::SimpleTextTableCell*>()->First([](auto x) {
-            return x->name == std::string("SimpleTextTableCell");
-        });
+        // only search for the prefab once, as it's a scan of every loaded object
+        if (!simpleTextTableCellInstance) {
+            simpleTextTableCellInstance = UnityEngine::Resources::FindObjectsOfTypeAll<GlobalNamespace::SimpleTextTableCell*>()->First([](auto x) {
+                return x->name == std::string("SimpleTextTableCell");
+            });
+        }
         tableCell = Instantiate(simpleTextTableCellInstance);
         tableCell->reuseIdentifier = reuseIdentifier;
 
         tableCell->_text->richText = true;
         tableCell->_text->enableWordWrapping = false;
         BSML::Lite::AddHoverHint(tableCell, "");
+
+        using HighlightDelegate = System::Action_2<UnityW<HMUI::SelectableCell>, HMUI::SelectableCell::TransitionType>;
+        std::function onHighlightChange = [this](UnityW<HMUI::SelectableCell> cell, HMUI::SelectableCell::TransitionType) {
+            if (cell->highlighted && onHighlight)
+                onHighlight(((HMUI::TableCell*) cell.unsafePtr())->idx);
+        };
+        tableCell->add_highlightDidChangeEvent(custom_types::MakeDelegate<HighlightDelegate*>(onHighlightChange));
     }
 
-    tableCell->text = data[idx];
-    if (failures.contains(idx)) {
-        tableCell->GetComponent<HMUI::HoverHint*>()->text = failures[idx];
+    if (auto failure = GetFailure(idx)) {
+        tableCell->text = fmt::format("<color=red>{}", GetName(idx));
+        tableCell->GetComponent<HMUI::HoverHint*>()->text = *failure;
         tableCell->interactable = false;
     } else {
-        tableCell->GetComponent<HMUI::HoverHint*>()->text = "";
+        tableCell->text = GetName(idx);
+        auto hint = GetHint(idx);
+        tableCell->GetComponent<HMUI::HoverHint*>()->text = hint ? *hint : "";
         tableCell->interactable = true;
     }
     tableCell->gameObject->active = true;
@@ -50,46 +116,122 @@ float CustomList::CellSize() {
 }
 
 int CustomList::NumberOfCells() {
-    return data.size();
+    return nameRanges.size();
 }
 
 int SettingsViewController::selectedIdx = -1;
+int SettingsViewController::pendingPreviewIdx = -1;
 std::vector<std::string> SettingsViewController::fullConfigPaths = {};
 
 void SettingsViewController::ConfigSelected(int idx) {
     selectedIdx = idx;
     getGlobalConfig().SelectedConfig.SetValue(fullConfigPaths[idx]);
+    // usually already loaded in the background while it was highlighted
     LoadCurrentConfig();
-    selectedConfig->text = "Current Config: " + configList->data[idx];
+    selectedConfig->text = fmt::format("Current Config: {}", configList->GetName(idx));
+    ShowPreview(idx);
+}
+
+void SettingsViewController::ConfigHighlighted(int idx) {
+    // the highlighted config first, then the ones most likely to be highlighted next
+    std::vector<std::string> paths;
+    for (int nearby : {idx, idx + 1, idx - 1}) {
+        if (nearby > 0 && nearby < (int) fullConfigPaths.size() && !configList->GetFailure(nearby))
+            paths.emplace_back(fullConfigPaths[nearby]);
+    }
+    PreloadSpeculative(std::move(paths));
+    ShowPreview(idx);
+}
+
+// example cuts from perfect to poor, with before, after, and accuracy always adding up to the total
+static CutScores const PreviewCuts[] = {
+    {.total = 115, .before = 70, .after = 30, .accuracy = 15, .timeDependence = 0.05, .maxScore = 115},
+    {.total = 108, .before = 70, .after = 27, .accuracy = 11, .timeDependence = 0.2, .maxScore = 115},
+    {.total = 101, .before = 68, .after = 25, .accuracy = 8, .timeDependence = 0.35, .maxScore = 115},
+    {.total = 88, .before = 60, .after = 20, .accuracy = 8, .timeDependence = 0.5, .maxScore = 115},
+    {.total = 62, .before = 42, .after = 12, .accuracy = 8, .timeDependence = 0.7, .maxScore = 115},
+};
+
+static std::string PreviewText(Config const& config) {
+    static JudgeContext context;
+    std::string ret;
+    for (auto& scores : PreviewCuts) {
+        auto [text, color, judgement] = JudgeCut(config, scores, context);
+        auto channel = [](float value) { return (int) std::lround(std::clamp(value, 0.0f, 1.0f) * 255); };
+        // judgments lose the closing tags at their end when the config is prepared, which would carry over into the samples after them
+        ret += fmt::format(
+            "<color=#{:02X}{:02X}{:02X}{:02X}>{}{}</color>   ", channel(color.r), channel(color.g), channel(color.b), channel(color.a), text, ClosingTags(text)
+        );
+    }
+    return ret;
+}
+
+void SettingsViewController::ShowPreview(int idx) {
+    pendingPreviewIdx = -1;
+    if (idx < 0 || idx >= (int) fullConfigPaths.size() || configList->GetFailure(idx)) {
+        previewText->text = "";
+        return;
+    }
+    auto& path = fullConfigPaths[idx];
+    auto config = path.empty() ? GetDefaultConfig() : GetCachedConfig(path);
+    // never load in the menu thread, instead waiting for the preload to finish
+    if (!config) {
+        pendingPreviewIdx = idx;
+        previewText->text = "Loading preview...";
+        return;
+    }
+    previewText->text = PreviewText(*config);
+}
+
+void SettingsViewController::Update() {
+    if (pendingPreviewIdx >= 0 && pendingPreviewIdx < (int) fullConfigPaths.size() && GetCachedConfig(fullConfigPaths[pendingPreviewIdx]))
+        ShowPreview(pendingPreviewIdx);
 }
 
 void SettingsViewController::RefreshConfigList() {
-    auto& failureMap = configList->failures;
-    auto& data = configList->data;
-    failureMap.clear();
-    data = {"Default"};
+    configList->Clear();
+    configList->Add("Default");
     fullConfigPaths = {""};
     if (getGlobalConfig().SelectedConfig.GetValue() == "")
         selectedIdx = 0;
 
-    Config config;
-    for (auto& entry : std::filesystem::recursive_directory_iterator(ConfigsPath())) {
-        std::string displayPath = entry.path().stem().string();
-        std::string fullPath = entry.path().string();
-        // test loading the config
-        try {
-            ReadFromFile(fullPath, config);
-        } catch (std::exception const& err) {
-            logger.error("Could not load config file {}: {}", fullPath, err.what());
-            data.emplace_back(fmt::format("<color=red>{}", displayPath));
+    std::vector<std::string> paths;
+    for (auto& entry : std::filesystem::recursive_directory_iterator(ConfigsPath()))
+        paths.emplace_back(entry.path().string());
+
+    // test loading the configs, with the details in a file next to the judgment logs
+    auto results = ValidateConfigs(paths);
+    if (!direxists(EventLogsPath()))
+        mkpath(EventLogsPath());
+    WriteValidationReport(ValidationReportPath(), results);
+
+    // checked against the score font without adding to its atlases for configs that may never be used,
+    // and only once for each character however many configs have it
+    std::vector<uint32_t> allGlyphs;
+    for (auto& result : results)
+        allGlyphs.insert(allGlyphs.end(), result.glyphs.begin(), result.glyphs.end());
+    std::sort(allGlyphs.begin(), allGlyphs.end());
+    allGlyphs.erase(std::unique(allGlyphs.begin(), allGlyphs.end()), allGlyphs.end());
+    auto allMissing = MissingGlyphs(GameplayFont(), allGlyphs);
+
+    for (auto& result : results) {
+        std::string displayPath = std::filesystem::path(result.path).stem().string();
+        std::string& fullPath = result.path;
+        if (result.error) {
+            logger.error("Could not load config file {}: {}", fullPath, *result.error);
+            configList->AddFailure(displayPath, fmt::format("Error loading config: {}", *result.error));
             fullConfigPaths.emplace_back(fullPath);
-            failureMap.insert({data.size() - 1, fmt::format("Error loading config: {}", err.what())});
             continue;
         }
-        data.emplace_back(displayPath);
+        std::vector<uint32_t> missing;
+        std::set_intersection(result.glyphs.begin(), result.glyphs.end(), allMissing.begin(), allMissing.end(), std::back_inserter(missing));
+        if (missing.empty())
+            configList->Add(displayPath);
+        else
+            configList->AddWithHint(displayPath, fmt::format("Missing characters: {}", GlyphsToString(missing)));
         fullConfigPaths.emplace_back(fullPath);
         if (getGlobalConfig().SelectedConfig.GetValue() == fullPath)
-            selectedIdx = data.size() - 1;
+            selectedIdx = fullConfigPaths.size() - 1;
     }
     configList->tableView->ReloadData();
     if (selectedIdx >= 0) {
@@ -100,12 +242,20 @@ void SettingsViewController::RefreshConfigList() {
 
 void SettingsViewController::RefreshUI() {
     RefreshConfigList();
-    selectedConfig->text = "Current Config: " + configList->data[selectedIdx];
+    selectedConfig->text = fmt::format("Current Config: {}", configList->GetName(selectedIdx));
     enabledToggle->toggle->isOn = getGlobalConfig().ModEnabled.GetValue();
     hideToggle->toggle->isOn = getGlobalConfig().HideUntilDone.GetValue();
+    statsToggle->toggle->isOn = getGlobalConfig().ShowStats.GetValue();
+    logToggle->toggle->isOn = getGlobalConfig().LogJudgements.GetValue();
+    streamToggle->toggle->isOn = getGlobalConfig().StreamJudgements.GetValue();
+    // a no-op when it is cached already, unless the file was edited since
+    if (selectedIdx > 0 && !configList->GetFailure(selectedIdx))
+        PreloadSpeculative({fullConfigPaths[selectedIdx]});
+    ShowPreview(selectedIdx);
 }
 
 void SettingsViewController::DidActivate(bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling) {
+    FinishConfigLoad();
     if (firstActivation) {
         gameObject->AddComponent<HMUI::Touchable*>();
         auto container = BSML::Lite::CreateVerticalLayoutGroup(transform);
@@ -118,6 +268,7 @@ void SettingsViewController::DidActivate(bool firstActivation, bool addedToHiera
 
         enabledToggle = BSML::Lite::CreateToggle(textLayout, "Mod Enabled", getGlobalConfig().ModEnabled.GetValue(), [](bool enabled) {
             getGlobalConfig().ModEnabled.SetValue(enabled);
+            UpdateActiveHooks();
         });
         BSML::Lite::AddHoverHint(enabledToggle, "Toggles whether the mod is active or not");
 
@@ -127,9 +278,32 @@ void SettingsViewController::DidActivate(bool firstActivation, bool addedToHiera
             });
         BSML::Lite::AddHoverHint(enabledToggle, "With this enabled, the hit scores will not be displayed until the score has been finalized");
 
+        statsToggle = BSML::Lite::CreateToggle(textLayout, "Show Stats on Results", getGlobalConfig().ShowStats.GetValue(), [](bool enabled) {
+            getGlobalConfig().ShowStats.SetValue(enabled);
+        });
+        BSML::Lite::AddHoverHint(statsToggle, "Shows averages, judgment counts, and accuracy by position for the song on the results screen");
+
+        logToggle = BSML::Lite::CreateToggle(textLayout, "Record Judgments", getGlobalConfig().LogJudgements.GetValue(), [](bool enabled) {
+            getGlobalConfig().LogJudgements.SetValue(enabled);
+            UpdateActiveHooks();
+        });
+        BSML::Lite::AddHoverHint(logToggle, "Saves every judged note of each song to a file, for designing config thresholds");
+
+        streamToggle = BSML::Lite::CreateToggle(textLayout, "Stream Judgments", getGlobalConfig().StreamJudgements.GetValue(), [](bool enabled) {
+            getGlobalConfig().StreamJudgements.SetValue(enabled);
+            UpdateActiveHooks();
+        });
+        BSML::Lite::AddHoverHint(streamToggle, "Sends every judged note to local programs, such as stream overlays connected through adb");
+
         selectedConfig = BSML::Lite::CreateText(textLayout, "");
 
         configList = BSML::Lite::CreateScrollableCustomSourceList<CustomList*>(container, {50, 50}, [this](int idx) { ConfigSelected(idx); });
+        configList->onHighlight = [this](int idx) { ConfigHighlighted(idx); };
+
+        previewText = BSML::Lite::CreateText(container, "");
+        previewText->richText = true;
+        previewText->enableWordWrapping = false;
+        previewText->alignment = TMPro::TextAlignmentOptions::Center;
     }
     RefreshUI();
 }
@@ -0,0 +1,97 @@
+#include "Stats.hpp"
+
+#include <algorithm>
+
+#include "Judgments.hpp"
+
+using namespace HSV;
+using ScoringType = GlobalNamespace::NoteData::ScoringType;
+
+static SongStats::Category GetCategory(ScoringType scoringType) {
+    if (scoringType == ScoringType::ChainHead || scoringType == ScoringType::ChainHeadArcTail)
+        return SongStats::ChainHead;
+    if (scoringType == ScoringType::ChainLink || scoringType == ScoringType::ChainLinkArcHead)
+        return SongStats::ChainLink;
+    return SongStats::Normal;
+}
+
+void SongStats::AddCut(CutScores const& scores, int hand, int judgement, int column, int row) {
+    auto category = GetCategory(scores.scoringType);
+    hand = std::clamp(hand, 0, Hands - 1);
+
+    before[hand][category][std::clamp(scores.before, 0, MaxBefore)]++;
+    after[hand][category][std::clamp(scores.after, 0, MaxAfter)]++;
+    accuracy[hand][category][std::clamp(scores.accuracy, 0, MaxAccuracy)]++;
+    judgements[category][std::clamp(judgement, 0, MaxJudgements - 1)]++;
+    timeDependence[std::clamp((int) (scores.timeDependence * TimeDependenceBins), 0, TimeDependenceBins - 1)]++;
+
+    if (category == ChainLink)
+        return;
+    // extended maps can place notes outside the normal grid
+    if (category == Normal && column >= 0 && column < Columns && row >= 0 && row < Rows) {
+        cellCuts[row][column]++;
+        cellAccuracy[row][column] += scores.accuracy;
+    }
+    int& oldest = recent[recentCount % RollingCount];
+    recentSum += scores.total - oldest;
+    oldest = scores.total;
+    recentCount++;
+}
+
+template <size_t N>
+static std::pair<float, uint32_t> Average(std::array<uint32_t, N> const& histogram) {
+    uint32_t count = 0;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < N; i++) {
+        count += histogram[i];
+        sum += i * histogram[i];
+    }
+    return {count ? (float) sum / count : 0, count};
+}
+
+std::string HSV::StatsSummary(SongStats const& stats, Config const& config) {
+    static constexpr std::string_view categoryNames[] = {"Notes", "Chain Heads", "Chain Links"};
+
+    std::string ret = "<b>Average Before - Accuracy - After</b>\n";
+    for (int category = 0; category < SongStats::CategoryCount; category++) {
+        auto [leftBefore, leftCount] = Average(stats.before[0][category]);
+        auto [rightBefore, rightCount] = Average(stats.before[1][category]);
+        if (leftCount + rightCount == 0)
+            continue;
+        ret += fmt::format(
+            "{}: Left {:.1f} - {:.1f} - {:.1f}, Right {:.1f} - {:.1f} - {:.1f}\n",
+            categoryNames[category],
+            leftBefore,
+            Average(stats.accuracy[0][category]).first,
+            Average(stats.after[0][category]).first,
+            rightBefore,
+            Average(stats.accuracy[1][category]).first,
+            Average(stats.after[1][category]).first
+        );
+    }
+
+    ret += "<b>Accuracy by Position</b>\n";
+    for (int row = SongStats::Rows - 1; row >= 0; row--) {
+        for (int column = 0; column < SongStats::Columns; column++) {
+            uint32_t cuts = stats.cellCuts[row][column];
+            ret += cuts ? fmt::format("{:5.2f} ", (float) stats.cellAccuracy[row][column] / cuts) : "  -   ";
+        }
+        ret += "\n";
+    }
+
+    ret += "<b>Judgments</b>\n";
+    int shown = std::min<int>(config.Judgements.size(), SongStats::MaxJudgements);
+    for (int i = 0; i < shown; i++)
+        ret += fmt::format("{}+: {}  ", config.Judgements[i].Threshold, stats.judgements[SongStats::Normal][i]);
+
+    float timeDependence = 0;
+    uint32_t cuts = 0;
+    for (int i = 0; i < SongStats::TimeDependenceBins; i++) {
+        timeDependence += (i + 0.5f) / SongStats::TimeDependenceBins * stats.timeDependence[i];
+        cuts += stats.timeDependence[i];
+    }
+    ret += fmt::format(
+        "\n<b>Average Time Dependence</b> {:.2f}\n<b>Bad Cuts</b> {}  <b>Misses</b> {}", cuts ? timeDependence / cuts : 0, stats.badCuts, stats.misses
+    );
+    return ret;
+}
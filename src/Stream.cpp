@@ -0,0 +1,220 @@
+#include "Stream.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Main.hpp"
+#include "RingBuffer.hpp"
+
+using namespace HSV;
+
+namespace {
+    struct Entry {
+        JudgmentEvent event;
+        uint8_t score = 0;
+        uint8_t color[4] = {};
+    };
+
+    struct Client {
+        int socket = -1;
+        // complete frames waiting to be sent, the first of which may be partly sent already
+        std::deque<std::string> frames;
+        size_t sent = 0;
+        size_t bytes = 0;
+    };
+}
+
+// a slow client loses its oldest frames past this, rather than slowing down anyone else
+static constexpr size_t ClientBacklog = 256 * 1024;
+static constexpr size_t EntrySize = 21;
+
+// Drained every 10ms, so it only fills when the server thread is stalled. Only the server can remove entries,
+// so at that point the newest are dropped, while a client that is slow to read loses its oldest frames instead.
+static RingBuffer<Entry, 4096> queue;
+static std::atomic<uint32_t> dropped = 0;
+static std::atomic<bool> running = false;
+// completed passes of the server loop, for FlushStream
+static std::atomic<uint32_t> passes = 0;
+static std::thread serverThread;
+static int serverPort = 0;
+// not retried, or logged again, until the port changes
+static int failedPort = 0;
+
+template <class T>
+static void Append(std::string& out, T value) {
+    out.append((char const*) &value, sizeof(T));
+}
+
+// u32 length of the rest of the frame, u16 number of entries, then each entry
+static std::string MakeFrame(std::vector<Entry> const& entries) {
+    std::string frame;
+    frame.reserve(6 + entries.size() * EntrySize);
+    Append<uint32_t>(frame, 2 + entries.size() * EntrySize);
+    Append<uint16_t>(frame, entries.size());
+    for (auto& entry : entries) {
+        auto& event = entry.event;
+        Append(frame, event.songTime);
+        Append(frame, event.timeDependence);
+        Append(frame, event.judgement);
+        Append(frame, event.type);
+        Append(frame, event.scoringType);
+        Append(frame, event.before);
+        Append(frame, event.after);
+        Append(frame, event.accuracy);
+        Append(frame, event.wrongDirection);
+        Append(frame, entry.score);
+        frame.append((char const*) entry.color, sizeof(entry.color));
+    }
+    return frame;
+}
+
+static void Queue(Client& client, std::string const& frame) {
+    client.frames.emplace_back(frame);
+    client.bytes += frame.size();
+    // never drop the front frame once it has started sending, or the client would lose its place in the stream
+    while (client.bytes > ClientBacklog && client.frames.size() > (client.sent ? 2 : 1)) {
+        auto drop = client.frames.begin() + (client.sent ? 1 : 0);
+        client.bytes -= drop->size();
+        client.frames.erase(drop);
+    }
+}
+
+// returns false when the client should be disconnected
+static bool Send(Client& client) {
+    while (!client.frames.empty()) {
+        auto& frame = client.frames.front();
+        ssize_t sent = send(client.socket, frame.data() + client.sent, frame.size() - client.sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        client.sent += sent;
+        if (client.sent < frame.size())
+            return true;
+        client.bytes -= frame.size();
+        client.frames.pop_front();
+        client.sent = 0;
+    }
+    return true;
+}
+
+static int OpenServer(int port) {
+    int server = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (server < 0)
+        return -1;
+    int reuse = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(server, (sockaddr*) &address, sizeof(address)) < 0 || listen(server, 4) < 0) {
+        close(server);
+        return -1;
+    }
+    return server;
+}
+
+static void ServerThread(int server) {
+    std::vector<Client> clients;
+    std::vector<Entry> batch;
+    std::vector<pollfd> polls;
+    while (running) {
+        polls.clear();
+        polls.push_back({server, POLLIN, 0});
+        for (auto& client : clients)
+            polls.push_back({client.socket, (short) (client.frames.empty() ? 0 : POLLOUT), 0});
+        // doubles as the delay between batches
+        poll(polls.data(), polls.size(), 10);
+
+        if (polls[0].revents & POLLIN) {
+            int client;
+            while ((client = accept4(server, nullptr, nullptr, SOCK_NONBLOCK)) >= 0)
+                clients.push_back({client});
+        }
+
+        batch.clear();
+        while (auto entry = queue.TryPop())
+            batch.push_back(*entry);
+        // keep frames within the u16 count
+        for (size_t start = 0; start < batch.size(); start += UINT16_MAX) {
+            std::vector<Entry> part(batch.begin() + start, batch.begin() + std::min(batch.size(), start + UINT16_MAX));
+            auto frame = MakeFrame(part);
+            for (auto& client : clients)
+                Queue(client, frame);
+        }
+
+        std::erase_if(clients, [](Client& client) {
+            if (Send(client))
+                return false;
+            close(client.socket);
+            return true;
+        });
+        passes++;
+        passes.notify_all();
+    }
+    for (auto& client : clients)
+        close(client.socket);
+    close(server);
+    if (uint32_t count = dropped.exchange(0))
+        logger.warn("Dropped {} judgments while streaming", count);
+    // wakes anything still flushing
+    passes++;
+    passes.notify_all();
+}
+
+void HSV::UpdateStreamServer(bool enabled, int port) {
+    if (running && (!enabled || port != serverPort))
+        running = false;
+    if (!running && serverThread.joinable())
+        serverThread.join();
+    if (!enabled || running || port == failedPort)
+        return;
+    int server = OpenServer(port);
+    if (server < 0) {
+        logger.error("Could not open judgment stream on port {}: {}", port, strerror(errno));
+        failedPort = port;
+        return;
+    }
+    failedPort = 0;
+    logger.info("Streaming judgments on port {}", port);
+    // discard anything left from a previous server
+    while (queue.TryPop())
+        ;
+    running = true;
+    serverPort = port;
+    serverThread = std::thread(ServerThread, server);
+}
+
+void HSV::FlushStream() {
+    // a pass may already be partway through, so wait for the end of the first one to start after this call
+    uint32_t start = passes;
+    for (uint32_t current = start; running && current - start < 2; current = passes)
+        passes.wait(current);
+}
+
+// std::thread terminates the game if it is destroyed while still joinable, so the server is stopped before the statics it uses go away
+static struct ServerShutdown {
+    ~ServerShutdown() { UpdateStreamServer(false, serverPort); }
+} serverShutdown;
+
+static uint8_t ColorByte(float value) {
+    return std::lround(std::clamp(value, 0.0f, 1.0f) * 255);
+}
+
+void HSV::StreamEvent(JudgmentEvent const& event, int score, UnityEngine::Color color) {
+    if (!running)
+        return;
+    if (!queue.TryPush({event, (uint8_t) score, {ColorByte(color.r), ColorByte(color.g), ColorByte(color.b), ColorByte(color.a)}}))
+        dropped++;
+}
@@ -0,0 +1,69 @@
+#include "Validation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#include "Glyphs.hpp"
+#include "Main.hpp"
+#include "json/Config.hpp"
+
+using namespace HSV;
+
+std::vector<ValidationResult> HSV::ValidateConfigs(std::vector<std::string> const& paths, size_t maxThreads) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<ValidationResult> results(paths.size());
+    std::atomic_size_t next = 0;
+
+    auto work = [&paths, &results, &next]() {
+        Config config;
+        for (size_t idx = next++; idx < paths.size(); idx = next++) {
+            auto& result = results[idx];
+            result.path = paths[idx];
+            auto parseStart = std::chrono::steady_clock::now();
+            try {
+                ReadFromFile(result.path, config);
+                result.glyphs = CollectGlyphs(config);
+            } catch (std::exception const& err) {
+                result.error = err.what();
+            }
+            result.parseTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - parseStart);
+        }
+    };
+
+    // the calling thread works as well, so only start the extra ones
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    size_t threadCount = std::min(maxThreads, paths.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; i++)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+
+    int failed = std::count_if(results.begin(), results.end(), [](ValidationResult const& result) { return result.error.has_value(); });
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    logger.info("Validated {} configs ({} failed) on {} threads in {} ms", results.size(), failed, std::max<size_t>(threadCount, 1), elapsed.count());
+
+    return results;
+}
+
+void HSV::WriteValidationReport(std::string const& path, std::vector<ValidationResult> const& results) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        logger.error("Could not write config validation report {}", path);
+        return;
+    }
+    file << "path\tstatus\tparse_us\tglyphs\terror\n";
+    for (auto& result : results) {
+        // keep each result on one line
+        std::string error = result.error.value_or("");
+        std::replace_if(error.begin(), error.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+        file << result.path << '\t' << (result.error ? "failed" : "ok") << '\t' << result.parseTime.count() << '\t' << result.glyphs.size() << '\t'
+             << error << '\n';
+    }
+    logger.debug("Wrote config validation report to {}", path);
+}
@@ -0,0 +1,377 @@
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Check.hpp"
+#include "FlatMap.hpp"
+#include "Judgments.hpp"
+#include "json/DefaultConfig.hpp"
+
+// Counts every heap allocation while each part of the per-note path runs, by replacing operator new and malloc,
+// failing if any part goes over its budget once warmed up and printing where each allocation came from.
+// Built without sanitizers, which replace the same functions.
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+    // frames kept for each allocation, including the hook itself
+    constexpr int StackDepth = 8;
+
+    struct Allocation {
+        char const* site;
+        char const* kind;
+        size_t bytes;
+        int depth;
+        void* stack[StackDepth];
+    };
+
+    // fixed storage, since the hooks can't allocate, with a limit for each site so one can't crowd out the rest
+    constexpr size_t KeptPerSite = 256;
+    std::array<Allocation, 4096> allocations;
+    size_t allocationCount = 0;
+    size_t siteCount = 0;
+    size_t totalCount = 0;
+    char const* currentSite = nullptr;
+    bool inHook = false;
+
+    void Record(char const* kind, size_t bytes) {
+        if (!currentSite || inHook)
+            return;
+        inHook = true;
+        totalCount++;
+        if (siteCount++ < KeptPerSite && allocationCount < allocations.size()) {
+            auto& allocation = allocations[allocationCount++];
+            allocation = {currentSite, kind, bytes, 0, {}};
+            allocation.depth = backtrace(allocation.stack, StackDepth);
+        }
+        inHook = false;
+    }
+}
+
+void* operator new(size_t size) {
+    Record("new", size);
+    if (void* ret = __libc_malloc(size ? size : 1))
+        return ret;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void operator delete(void* ptr) noexcept {
+    __libc_free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    __libc_free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    __libc_free(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept {
+    __libc_free(ptr);
+}
+
+extern "C" {
+void* malloc(size_t size) {
+    Record("malloc", size);
+    return __libc_malloc(size);
+}
+void* calloc(size_t count, size_t size) {
+    Record("calloc", count * size);
+    return __libc_calloc(count, size);
+}
+void* realloc(void* ptr, size_t size) {
+    if (size)
+        Record("realloc", size);
+    return __libc_realloc(ptr, size);
+}
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+}
+
+struct SiteResult {
+    char const* site;
+    size_t warmup;
+    size_t steady;
+    size_t notes;
+};
+
+static constexpr size_t WarmupNotes = 1000;
+static constexpr size_t SteadyNotes = 100000;
+// allocations allowed per note once warmed up, for every part of the path the mod owns
+static constexpr double PerNoteBudget = 0;
+
+// runs note(i) for warmup and then steady state notes, counting allocations in each
+template <class F>
+static SiteResult Measure(char const* site, F&& note) {
+    SiteResult result = {site, 0, 0, SteadyNotes};
+    size_t before = totalCount;
+    currentSite = site;
+    siteCount = 0;
+    for (size_t i = 0; i < WarmupNotes; i++)
+        note(i);
+    result.warmup = totalCount - before;
+    before = totalCount;
+    for (size_t i = WarmupNotes; i < WarmupNotes + SteadyNotes; i++)
+        note(i);
+    currentSite = nullptr;
+    result.steady = totalCount - before;
+    return result;
+}
+
+static std::string Symbol(Dl_info const& info) {
+    if (!info.dli_sname)
+        return "??";
+    int status;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string ret = status == 0 ? demangled : info.dli_sname;
+    std::free(demangled);
+    std::string_view const longString = "std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> >";
+    for (size_t pos; (pos = ret.find(longString)) != std::string::npos;)
+        ret.replace(pos, longString.size(), "std::string");
+    // templates make for very long names
+    if (ret.size() > 60)
+        ret = ret.substr(0, 57) + "...";
+    return ret;
+}
+
+// allocations grouped by site and call site, being the function that allocated and its first caller outside the standard library
+static void PrintCallSites() {
+    struct CallSite {
+        char const* site;
+        std::string caller;
+        size_t count;
+        size_t bytes;
+    };
+    std::vector<CallSite> callSites;
+    for (size_t i = 0; i < allocationCount; i++) {
+        auto& allocation = allocations[i];
+        // skipping Record and the hook
+        Dl_info info = {};
+        if (allocation.depth > 2)
+            dladdr(allocation.stack[2], &info);
+        std::string function = Symbol(info);
+        std::string caller = std::string(allocation.kind) + " in " + function;
+        bool inLibrary = function.starts_with("std::");
+        for (int frame = 3; frame < allocation.depth && inLibrary; frame++) {
+            // static functions have no symbol, so are skipped too
+            if (dladdr(allocation.stack[frame], &info) && (function = Symbol(info)) != "??" && !function.starts_with("std::")) {
+                caller += " from " + function;
+                inLibrary = false;
+            }
+        }
+        auto itr = std::find_if(callSites.begin(), callSites.end(), [&](CallSite const& callSite) {
+            return callSite.site == allocation.site && callSite.caller == caller;
+        });
+        if (itr == callSites.end())
+            callSites.push_back({allocation.site, caller, 1, allocation.bytes});
+        else {
+            itr->count++;
+            itr->bytes += allocation.bytes;
+        }
+    }
+    std::printf("\n%-24s %7s %8s  %s\n", "site", "allocs", "bytes", "call site");
+    for (auto& callSite : callSites)
+        std::printf("%-24s %7zu %8zu  %s\n", callSite.site, callSite.count, callSite.bytes, callSite.caller.c_str());
+    if (totalCount > allocationCount)
+        std::printf("(the first %zu of each site are broken down, %zu in total)\n", KeptPerSite, allocationCount);
+}
+
+static constexpr HSV::BadCutType BadCuts[] = {HSV::BadCutType::WrongDirection, HSV::BadCutType::WrongColor, HSV::BadCutType::Bomb};
+
+// between them every token, segment kind, and display, along with the default config, which has no JSON here
+static constexpr std::pair<char const*, std::string_view> Configs[] = {
+    {"JudgeCut default", ""},
+    {"JudgeCut numbers",
+     R"json({
+        "judgments": [
+            {"threshold": 110, "text": "%s %p%% %t", "color": [1, 1, 1, 1]},
+            {"threshold": 60, "text": "<size=80%>%b %c %a</size>\n%d %r", "color": [0, 1, 0, 1], "fade": true},
+            {"text": "%s\n%b + %c + %a = %s (%r)", "color": [1, 0, 0, 1]}
+        ],
+        "timeDependencyDecimalPrecision": 3,
+        "timeDependencyDecimalOffset": 0,
+        "badCutDisplays": [{"text": "x", "color": [1, 0, 0, 1]}],
+        "missDisplays": [{"text": "miss", "color": [1, 0, 0, 1]}]
+    })json"},
+    {"JudgeCut segments",
+     R"json({
+        "judgments": [
+            {"threshold": 100, "text": "%B%C%s%A\n%T", "color": [1, 1, 1, 1], "fade": true},
+            {"text": "%B %C %A %T %t", "color": [1, 0, 0, 1]}
+        ],
+        "beforeCutAngleJudgments": [{"threshold": 70, "text": "+"}, {"text": "-"}],
+        "accuracyJudgments": [{"threshold": 15, "text": "<u>"}, {"threshold": 10, "text": "."}, {"text": ""}],
+        "afterCutAngleJudgments": [{"threshold": 30, "text": "+"}, {"text": "-"}],
+        "timeDependencyJudgments": [{"threshold": 0.5, "text": "late"}, {"threshold": 0.1, "text": "ok"}, {"text": "early"}],
+        "badCutDisplays": [
+            {"text": "direction", "type": "WrongDirection", "color": [1, 0, 0, 1]},
+            {"text": "color", "type": "WrongColor", "color": [1, 0, 0, 1]},
+            {"text": "bomb", "type": "Bomb", "color": [1, 0, 0, 1]},
+            {"text": "any", "type": "All", "color": [1, 0, 0, 1]}
+        ],
+        "randomizeBadCutDisplays": true
+    })json"},
+    {"JudgeCut chains",
+     R"json({
+        "judgments": [{"text": "%s", "color": [1, 1, 1, 1]}],
+        "chainHeadJudgments": [
+            {"threshold": 80, "text": "%b %c %p%%", "color": [1, 1, 1, 1], "fade": true},
+            {"text": "%B%C %t %d", "color": [1, 0, 0, 1]}
+        ],
+        "chainLinkDisplay": {"text": "%s/20 %p %r", "color": [1, 1, 1, 0.5]},
+        "beforeCutAngleJudgments": [{"threshold": 70, "text": "+"}, {"text": "-"}],
+        "accuracyJudgments": [{"threshold": 15, "text": "<u>"}, {"text": ""}],
+        "missDisplays": [{"text": "miss", "color": [1, 0, 0, 1]}, {"text": "MISS", "color": [1, 0, 0, 1]}],
+        "randomizeMissDisplays": true
+    })json"},
+};
+
+// chain notes the config has no judgements for, which are left to the game as in SkipJudge in Main.cpp
+static bool Skipped(HSV::Config const& config, HSV::CutScores const& scores) {
+    if (scores.scoringType == GlobalNamespace::NoteData::ScoringType::ChainHead)
+        return !config.HasChainHead();
+    if (scores.scoringType == GlobalNamespace::NoteData::ScoringType::ChainLink)
+        return !config.HasChainLink();
+    return false;
+}
+
+int main() {
+    // loads the unwinder, which allocates the first time
+    void* warm[1];
+    backtrace(warm, 1);
+
+    std::mt19937 rng(43);
+    std::uniform_int_distribution<int> score(0, 115);
+    std::uniform_real_distribution<float> time(0, 1);
+
+    auto config = DefaultConfig();
+    std::vector<HSV::CutScores> notes(WarmupNotes + SteadyNotes);
+    for (auto& note : notes) {
+        note = {
+            .total = score(rng),
+            .before = score(rng) % 71,
+            .after = score(rng) % 31,
+            .accuracy = score(rng) % 16,
+            .timeDependence = time(rng),
+            .maxScore = 115,
+            .wrongDirection = (HSV::Direction) (score(rng) % 8),
+        };
+        int type = score(rng);
+        if (type < 10) {
+            note.scoringType = GlobalNamespace::NoteData::ScoringType::ChainLink;
+            note.total %= 21;
+            note.maxScore = 20;
+        } else if (type < 20) {
+            note.scoringType = GlobalNamespace::NoteData::ScoringType::ChainHead;
+            note.total = note.before + note.accuracy;
+            note.maxScore = 85;
+        }
+    }
+
+    std::vector<SiteResult> results;
+
+    // how judgements were formatted before, building new strings for each note, to show that the hooks see allocations
+    std::string old;
+    auto control = Measure("old formatting", [&](size_t i) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << (notes[i].timeDependence * 100);
+        old = "<size=80%>" + std::to_string(notes[i].total) + "</size>\n" + ss.str();
+    });
+    CHECK(control.steady > 0);
+    results.push_back(control);
+
+    // numbers of different lengths, so the storage grows once for the longest and is then reused
+    static constexpr std::string_view stored[] = {"7", "115", "0.5", "12.3456789012345678901234567890", "100.000000", "7.000000"};
+    TokenizedText::Values values;
+    results.push_back(Measure("Values::Store", [&](size_t i) {
+        values.Store(TokenizedText::Token::Score, stored[i % 2]);
+        values.Store(TokenizedText::Token::TimeDependency, stored[2 + i % 2]);
+        values.Store(TokenizedText::Token::Percent, stored[4 + i % 2]);
+    }));
+
+    // every template in the default config, into the same output each time
+    std::string out;
+    values.Set(TokenizedText::Token::BeforeCutSegment, " + ");
+    values.Set(TokenizedText::Token::AccuracySegment, "<u>");
+    values.Set(TokenizedText::Token::AfterCutSegment, "<color=#ff4f4f> - </color>");
+    results.push_back(Measure("TokenizedText::Format", [&](size_t i) {
+        out.clear();
+        config.Judgements[i % config.Judgements.size()].Text.Format(values, out);
+    }));
+
+    // a handful of notes in flight at once, each added when cut and removed when finished
+    HSV::FlatMap<void*, int> map;
+    results.push_back(Measure("FlatMap", [&](size_t i) {
+        map.insert_or_assign((void*) (i % 97 + 1), (int) i);
+        if (i >= 6)
+            map.erase((void*) ((i - 6) % 97 + 1));
+    }));
+
+    HSV::SongStats stats;
+    results.push_back(Measure("SongStats::AddCut", [&](size_t i) { stats.AddCut(notes[i], i % 2, i % 6, i % 4, i % 3); }));
+
+    // each config through every way a note can be judged, with a bad cut or miss every few notes as in a song
+    std::array<bool, TokenizedText::TokenCount> covered = {};
+    for (auto& [site, json] : Configs) {
+        HSV::Config loaded;
+        if (!json.empty())
+            ReadFromString(json, loaded);
+        else
+            loaded = config;
+        HSV::PrepareForJudging(loaded);
+        auto cover = [&covered](HSV::Judgement const& judgement) {
+            for (size_t token = 1; token < covered.size(); token++)
+                covered[token] = covered[token] || judgement.Text.Uses((TokenizedText::Token) token);
+        };
+        std::for_each(loaded.Judgements.begin(), loaded.Judgements.end(), cover);
+        std::for_each(loaded.ChainHeadJudgements.begin(), loaded.ChainHeadJudgements.end(), cover);
+        if (loaded.ChainLinkDisplay)
+            cover(*loaded.ChainLinkDisplay);
+        HSV::JudgeContext context;
+        results.push_back(Measure(site, [&](size_t i) {
+            if (!Skipped(loaded, notes[i]))
+                CHECK(!HSV::JudgeCut(loaded, notes[i], context).text.empty());
+            if (i % 8 == 0)
+                HSV::GetBadCutDisplay(loaded, BadCuts[i / 8 % std::size(BadCuts)], context);
+            else if (i % 8 == 1)
+                HSV::GetMissDisplay(loaded, context);
+        }));
+    }
+
+    // so a token added later without a config here that uses it fails
+    CHECK(std::all_of(covered.begin() + 1, covered.end(), [](bool used) { return used; }));
+
+    std::printf("%-24s %14s %16s %8s\n", "site", "warmup allocs", "allocs per note", "budget");
+    for (auto& result : results) {
+        double perNote = (double) result.steady / result.notes;
+        bool isControl = result.site == control.site;
+        char budget[16] = "-";
+        if (!isControl)
+            std::snprintf(budget, sizeof(budget), "%.3f", PerNoteBudget);
+        std::printf("%-24s %14zu %16.3f %8s\n", result.site, result.warmup, perNote, budget);
+        if (!isControl)
+            CHECK(perNote <= PerNoteBudget);
+    }
+    PrintCallSites();
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+// Aborts on failure, so that it fails under ctest and counts as a crash under a fuzzer
+#define CHECK(expr)                                                                  \
+    do {                                                                             \
+        if (!(expr)) {                                                               \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            std::abort();                                                            \
+        }                                                                            \
+    } while (0)
+
+#define CHECK_TEXT(actual, expected) CheckText(actual, expected, #actual, __FILE__, __LINE__)
+
+inline void CheckText(std::string_view actual, std::string_view expected, char const* expr, char const* file, int line) {
+    if (actual == expected)
+        return;
+    std::fprintf(stderr, "%s:%d: %s\n  was:      \"%.*s\"\n  expected: \"%.*s\"\n", file, line, expr, (int) actual.size(), actual.data(), (int) expected.size(), expected.data());
+    std::abort();
+}
@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "Check.hpp"
+#include "json/Config.hpp"
+#include "json/DefaultConfig.hpp"
+
+// Loading configs from JSON: the default config file, and each validator and kind of error on known cases.
+// config_test [default_config.json]
+
+// the message a config fails to load with, or empty if it loads
+static std::string LoadError(std::string_view json) {
+    HSV::Config config;
+    try {
+        ReadFromString(json, config);
+    } catch (JSONException const& error) {
+        return error.what();
+    }
+    return "";
+}
+
+static void CheckError(std::string_view json, std::string_view expected) {
+    std::string error = LoadError(json);
+    if (error.find(expected) == std::string::npos) {
+        std::fprintf(stderr, "loading %.*s\n", (int) json.size(), json.data());
+        CHECK_TEXT(error, expected);
+    }
+}
+
+static void CheckJudgements(std::vector<HSV::Judgement> const& loaded, std::vector<HSV::Judgement> const& expected) {
+    CHECK(loaded.size() == expected.size());
+    for (size_t i = 0; i < loaded.size(); i++) {
+        CHECK_TEXT(loaded[i].Text.original, expected[i].Text.original);
+        CHECK(loaded[i].Text == expected[i].Text);
+        CHECK(loaded[i].Threshold == expected[i].Threshold);
+        CHECK(loaded[i].Color.RawColor == expected[i].Color.RawColor);
+        CHECK(loaded[i].Fade.value_or(false) == expected[i].Fade.value_or(false));
+    }
+}
+
+static void TestDefaultConfig(char const* path) {
+    HSV::Config loaded;
+    ReadFromFile(path, loaded);
+    auto expected = DefaultConfig();
+    CheckJudgements(loaded.Judgements, expected.Judgements);
+    CheckJudgements(loaded.ChainHeadJudgements, expected.ChainHeadJudgements);
+    CHECK(loaded.ChainLinkDisplay && expected.ChainLinkDisplay);
+    CheckJudgements({*loaded.ChainLinkDisplay}, {*expected.ChainLinkDisplay});
+    CHECK(loaded.BeforeCutAngleSegments.size() == expected.BeforeCutAngleSegments.size());
+    CHECK(loaded.TimeDependenceDecimalPrecision == expected.TimeDependenceDecimalPrecision);
+    CHECK(loaded.TimeDependenceDecimalOffset == expected.TimeDependenceDecimalOffset);
+}
+
+static constexpr std::string_view Minimal = R"({"judgments": [{"text": "%s", "color": [1, 1, 1, 1]}]})";
+
+int main(int argc, char** argv) {
+    if (argc > 1)
+        TestDefaultConfig(argv[1]);
+
+    CHECK_TEXT(LoadError(Minimal), "");
+
+    // each validator
+    CheckError(R"({"judgments": []})", "no judgements found in config");
+    CheckError(R"({"judgments": [{"text": "%s", "color": [1, 1, 1]}]})", "invalid color array length");
+    CheckError(
+        R"({"judgments": [{"text": "%s", "color": [1, 1, 1, 1]}], "badCutDisplays": [{"text": "x", "type": "bomb", "color": [1, 1, 1, 1]}]})",
+        "badCutDisplays[0]: invalid display type \"bomb\""
+    );
+    CheckError(R"({"judgments": [{"text": "%s", "color": [1, 1, 1, 1]}], "timeDependencyDecimalPrecision": 100})", "timeDependencyDecimalPrecision must be");
+    CheckError(R"({"judgments": [{"text": "%s", "color": [1, 1, 1, 1]}], "timeDependencyDecimalOffset": -1})", "timeDependencyDecimalOffset must be");
+
+    // missing and mistyped values
+    CheckError("{}", "judgments not found");
+    CheckError(R"({"judgments": [{"color": [1, 1, 1, 1]}]})", "judgments[0].text not found");
+    CheckError(R"({"judgments": [{"text": "%s", "color": [1, 1, 1, 1], "threshold": 1.5}]})", "judgments[0].threshold, type expected was: int");
+    CheckError(R"({"judgments": [{"text": "%s", "color": [1, 1, 1, 1], "threshold": 2147483648}]})", "type expected was: int");
+    CheckError(R"({"judgments": [{"text": "%s", "color": [1, "1", 1, 1]}]})", "judgments[0].color[1], type expected was: float");
+    CheckError(R"({"judgments": {}})", "judgments, type expected was: array");
+    CheckError("[]", "type expected was: object");
+
+    // malformed JSON
+    CheckError("", "parse error at offset 0");
+    CheckError(Minimal.substr(0, Minimal.size() - 1), "parse error");
+    CheckError(std::string(Minimal) + "}", "must not be followed by other values");
+    CheckError(R"({"judgments": [{"text": "\ud800", "color": [1, 1, 1, 1]}]})", "surrogate pair");
+    CheckError(R"({"judgments": [01]})", "leading zeros");
+    CheckError(std::string(10000, '[') + std::string(10000, ']'), "too deeply nested");
+
+    HSV::Config config;
+    bool threw = false;
+    try {
+        ReadFromFile("/nonexistent/config.json", config);
+    } catch (JSONException const&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    std::printf("passed\n");
+    return 0;
+}
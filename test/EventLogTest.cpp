@@ -0,0 +1,81 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "EventLog.hpp"
+
+// bytes per event across all the columns of a log file
+static constexpr size_t EventSize = 4 + 4 + 2 + 6;
+static constexpr size_t HeaderSize = 12;
+
+// the file once the writer thread has finished it, or empty if it never does
+static std::vector<char> WaitForFile(std::filesystem::path const& path) {
+    for (int i = 0; i < 500; i++) {
+        std::error_code error;
+        size_t size = std::filesystem::file_size(path, error);
+        if (!error && size >= HeaderSize) {
+            uint32_t count = 0;
+            std::ifstream file(path, std::ios::binary);
+            std::vector<char> ret((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::memcpy(&count, ret.data() + 8, sizeof(count));
+            if (ret.size() == HeaderSize + count * EventSize)
+                return ret;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return {};
+}
+
+static uint32_t Count(std::vector<char> const& file) {
+    uint32_t count;
+    std::memcpy(&count, file.data() + 8, sizeof(count));
+    return count;
+}
+
+int main() {
+    auto dir = std::filesystem::temp_directory_path() / ("hsv-event-log-test-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+
+    // a short song, written exactly
+    HSV::BeginEventLog(dir / "short.hsvl");
+    for (int i = 0; i < 3; i++)
+        HSV::LogEvent({.songTime = (float) i, .judgement = (int16_t) i, .type = HSV::EventType::Miss, .before = 70});
+    HSV::EndEventLog();
+
+    auto file = WaitForFile(dir / "short.hsvl");
+    CHECK(!file.empty());
+    CHECK(std::memcmp(file.data(), "HSVL", 4) == 0);
+    uint32_t version;
+    std::memcpy(&version, file.data() + 4, sizeof(version));
+    CHECK(version == 1);
+    CHECK(Count(file) == 3);
+    float songTimes[3];
+    std::memcpy(songTimes, file.data() + HeaderSize, sizeof(songTimes));
+    CHECK(songTimes[0] == 0 && songTimes[1] == 1 && songTimes[2] == 2);
+    // the type column, after the two float and one int16 columns
+    CHECK(file[HeaderSize + 3 * 10] == (char) HSV::EventType::Miss);
+
+    // far more than the queue holds at once, so events are dropped but the end of the song still has to get through
+    HSV::BeginEventLog(dir / "flooded.hsvl");
+    for (int i = 0; i < 100000; i++)
+        HSV::LogEvent({.songTime = (float) i});
+    HSV::EndEventLog();
+
+    file = WaitForFile(dir / "flooded.hsvl");
+    CHECK(!file.empty());
+    CHECK(Count(file) > 0 && Count(file) <= 100000);
+    std::printf("flooded song kept %u of 100000 events\n", Count(file));
+
+    std::filesystem::remove_all(dir);
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "Check.hpp"
+#include "TokenizedText.hpp"
+
+// Each template shape with a specialized formatter, formatted through both it and the generic formatter.
+// format_benchmark [iterations per shape]
+
+using Clock = std::chrono::steady_clock;
+using Token = TokenizedText::Token;
+
+static char SpecifierFor(Token token) {
+    for (char specifier : std::string_view("bcatBCATpsdr")) {
+        if (TokenizedText::TokenFor(specifier) == token)
+            return specifier;
+    }
+    return 0;
+}
+
+// a template with exactly the entry's shape, with tags like the default config's as its literals
+static std::string TemplateFor(TokenFormatters::Entry const& entry) {
+    std::string ret;
+    for (size_t i = 0; i < entry.size; i++) {
+        if (entry.shape[i] == Token::Literal)
+            ret += i == 0 ? "<size=150><u>" : "</u></size>";
+        else
+            ret += {'%', SpecifierFor(entry.shape[i])};
+    }
+    return ret;
+}
+
+static double NanosecondsPerFormat(TokenizedText::Formatter format, TokenizedText const& text, TokenizedText::Values const& values, size_t iterations) {
+    std::string out;
+    size_t length = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        out.clear();
+        format(text, values, out);
+        length += out.size();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    // so the loop can't be optimized away
+    CHECK(length > 0);
+    return seconds * 1e9 / iterations;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::atol(argv[1]) : 5000000;
+
+    TokenizedText::Values values;
+    values.Set(Token::Score, "115");
+    values.Set(Token::Percent, "100.000000");
+    values.Set(Token::BeforeCutSegment, " + ");
+    values.Set(Token::AccuracySegment, "<u>");
+    values.Set(Token::AfterCutSegment, "<color=#ff4f4f> - </color>");
+
+    std::printf("%-36s %12s %12s %8s\n", "template", "generic ns", "special ns", "speedup");
+    for (auto const& entry : TokenFormatters::Specializations) {
+        TokenizedText text(TemplateFor(entry));
+        CHECK(std::equal(text.tokenTypes.begin(), text.tokenTypes.end(), entry.shape, entry.shape + entry.size));
+
+        std::string generic, specialized, selected;
+        TokenFormatters::Generic(text, values, generic);
+        entry.format(text, values, specialized);
+        text.Format(values, selected);
+        CHECK_TEXT(specialized, generic);
+        CHECK_TEXT(selected, generic);
+
+        double genericTime = NanosecondsPerFormat(&TokenFormatters::Generic, text, values, iterations);
+        double specializedTime = NanosecondsPerFormat(entry.format, text, values, iterations);
+        std::printf("%-36s %12.2f %12.2f %7.2fx\n", text.original.c_str(), genericTime, specializedTime, genericTime / specializedTime);
+    }
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+#include "Check.hpp"
+#include "Judgments.hpp"
+
+// Fuzz target for config files: libFuzzer calls it directly, and FuzzConfigMain.cpp drives it with generated configs otherwise.
+// Anything the parser or validators reject has to come back as a JSONException, and anything they accept has to be safe to judge with.
+
+using ScoringType = GlobalNamespace::NoteData::ScoringType;
+
+static void CheckColor(HSV::ColorArray const& color) {
+    CHECK(color.RawColor.size() == 4);
+    CHECK(color.Color.r == color.RawColor[0] && color.Color.g == color.RawColor[1]);
+    CHECK(color.Color.b == color.RawColor[2] && color.Color.a == color.RawColor[3]);
+}
+
+// what the validators guarantee about every config they let through
+static void CheckValid(HSV::Config const& config) {
+    CHECK(!config.Judgements.empty());
+    CHECK(config.TimeDependenceDecimalPrecision >= 0 && config.TimeDependenceDecimalPrecision <= 99);
+    CHECK(config.TimeDependenceDecimalOffset >= 0 && config.TimeDependenceDecimalOffset <= 38);
+    for (auto& judgement : config.Judgements)
+        CheckColor(judgement.Color);
+    for (auto& judgement : config.ChainHeadJudgements)
+        CheckColor(judgement.Color);
+    if (config.ChainLinkDisplay)
+        CheckColor(config.ChainLinkDisplay->Color);
+    size_t all = 0;
+    for (auto& display : config.BadCutDisplays) {
+        CHECK(std::find(HSV::BadCutTypes.begin(), HSV::BadCutTypes.end(), display.Type) != HSV::BadCutTypes.end());
+        CheckColor(display.Color);
+        all += display.Type == HSV::BadCutTypes[0];
+    }
+    CHECK(config.WrongDirections.size() + config.WrongColors.size() + config.Bombs.size() == config.BadCutDisplays.size() + all * 2);
+    for (auto& display : config.MissDisplays)
+        CheckColor(display.Color);
+}
+
+// every kind of note across the whole range of scores, routed the way the hooks in Main.cpp route them
+static void JudgeEverything(HSV::Config const& config) {
+    HSV::JudgeContext context;
+    for (int total = -1; total <= 116; total += 3) {
+        HSV::CutScores scores = {
+            .total = total,
+            .before = total % 71,
+            .after = total % 31,
+            .accuracy = total % 16,
+            .timeDependence = total / 116.0f,
+            .maxScore = 115,
+            .wrongDirection = (HSV::Direction) (total & 7),
+        };
+        // cuts are recorded with the judgement they were displayed with, which has to be the one GetUsedJudgement finds for the rest
+        auto judgeAndCheck = [&config, &scores, &context]() {
+            CHECK(HSV::JudgeCut(config, scores, context).judgement == HSV::GetUsedJudgement(config, scores).first);
+        };
+        judgeAndCheck();
+        if (config.HasChainHead()) {
+            scores.scoringType = ScoringType::ChainHead;
+            scores.maxScore = 85;
+            judgeAndCheck();
+        }
+        if (config.HasChainLink()) {
+            scores = {.total = total % 21, .maxScore = 20, .scoringType = ScoringType::ChainLink};
+            judgeAndCheck();
+        }
+        context.stats.AddCut(scores, total & 1, 0, total & 3, total % 3);
+    }
+    for (auto type : {HSV::BadCutType::WrongDirection, HSV::BadCutType::WrongColor, HSV::BadCutType::Bomb})
+        HSV::GetBadCutDisplay(config, type, context);
+    HSV::GetMissDisplay(config, context);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+    HSV::Config config;
+    try {
+        ReadFromString(std::string_view((char const*) data, size), config);
+    } catch (JSONException const&) {
+        // shown in the config list as the reason it failed to load
+        return 0;
+    }
+    CheckValid(config);
+    HSV::PrepareForJudging(config);
+    JudgeEverything(config);
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+
+// Runs the config fuzz target without libFuzzer: first over the given files, then over generated configs.
+// Each has any of the fields of a config, and half of them have faults: missing or repeated fields, values out of range or of the wrong type,
+// and bytes changed afterwards so it isn't valid JSON anymore.
+// fuzz_config [iterations] [seed] [config files...]
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size);
+
+static void Run(std::string_view json) {
+    LLVMFuzzerTestOneInput((uint8_t const*) json.data(), json.size());
+}
+
+class Generator {
+   public:
+    explicit Generator(unsigned seed) : rng(seed) {}
+
+    std::string Config() {
+        out.clear();
+        faulty = Chance(50);
+        Object([this]() {
+            Field("judgments", [this]() { Array([this]() { Judgement(); }); }, true);
+            Field("chainHeadJudgments", [this]() { Array([this]() { Judgement(); }); });
+            Field("chainLinkDisplay", [this]() { Judgement(); });
+            for (auto name : {"beforeCutAngleJudgments", "accuracyJudgments", "afterCutAngleJudgments"})
+                Field(name, [this]() { Array([this]() { Object([this]() { Field("threshold", [this]() { Pick(Ints); }); Field("text", [this]() { Text(); }, true); }); }); });
+            Field("timeDependencyJudgments", [this]() {
+                Array([this]() { Object([this]() { Field("threshold", [this]() { Pick(Floats); }); Field("text", [this]() { Text(); }, true); }); });
+            });
+            for (auto name : {"fixedPosX", "fixedPosY", "fixedPosZ"})
+                Field(name, [this]() { Pick(Floats); });
+            Field("useFixedPos", [this]() { Bool(); });
+            for (auto name : {"fixedPosition", "targetPositionOffset"})
+                Field(name, [this]() { Object([this]() { Field("x", [this]() { Pick(Floats); }, true); Field("y", [this]() { Pick(Floats); }, true); Field("z", [this]() { Pick(Floats); }, true); }); });
+            Field("timeDependencyDecimalPrecision", [this]() { faulty ? Pick(Ints) : Pick(InRange); });
+            Field("timeDependencyDecimalOffset", [this]() { faulty ? Pick(Ints) : Pick(InRange); });
+            Field("badCutDisplays", [this]() {
+                Array([this]() {
+                    Object([this]() {
+                        Field("text", [this]() { Text(); }, true);
+                        Field("type", [this]() { out += BadCutTypes[Below(Fault(20) ? std::size(BadCutTypes) : 4)]; });
+                        Field("color", [this]() { Color(); }, true);
+                    });
+                });
+            });
+            Field("randomizeBadCutDisplays", [this]() { Bool(); });
+            Field("missDisplays", [this]() { Array([this]() { Object([this]() { Field("text", [this]() { Text(); }, true); Field("color", [this]() { Color(); }, true); }); }); });
+            Field("randomizeMissDisplays", [this]() { Bool(); });
+        });
+        if (Fault(30))
+            Mutate();
+        return out;
+    }
+
+   private:
+    static constexpr std::string_view Ints[] = {"0", "1", "2", "-1", "20", "38", "39", "50", "85", "99", "100", "110", "115", "-2147483648", "2147483647", "-0"};
+    // for the decimal precision and offset
+    static constexpr std::string_view InRange[] = {"0", "1", "2", "20", "38"};
+    static constexpr std::string_view Floats[] = {"0", "0.5", "1", "1.0", "-1", "0.25", "1e38", "3.5e38", "1e-45", "1e308", "-2147483648", "2147483648"};
+    // already escaped for JSON
+    static constexpr std::string_view TextPieces[] = {
+        "%s", "%p", "%t", "%b", "%c", "%a", "%d", "%r", "%B", "%C", "%A", "%T", "%n", "%%", "%", "<u>", "</u>", "<size=80%>", "</size>", "<color=#ff4f4f>",
+        "</color>", "<noparse>", "</noparse>", "<", ">", " ", "x", "\\\"", "\\\\", "\\n", "\\u2197", "\\ud83d\\ude00", "\\u0000", "↗",
+    };
+    static constexpr std::string_view BadCutTypes[] = {"\"All\"", "\"WrongDirection\"", "\"WrongColor\"", "\"Bomb\"", "\"bomb\"", "\"\""};
+    static constexpr std::string_view WrongTypes[] = {"null", "true", "\"1\"", "1", "1.5", "[]", "{}", "[1, 2, 3, 4]"};
+    static constexpr std::string_view Garbage[] = {"{", "}", "[", "]", ",", ":", "\"", "\\", "nul", "1e", "-", "\x80", "\xff", " "};
+
+    bool Chance(int percent) { return std::uniform_int_distribution<int>(0, 99)(rng) < percent; }
+    bool Fault(int percent) { return faulty && Chance(percent); }
+    int Below(int count) { return std::uniform_int_distribution<int>(0, count - 1)(rng); }
+
+    template <size_t N>
+    void Pick(std::string_view const (&from)[N]) {
+        out += from[Below(N)];
+    }
+
+    template <class F>
+    void Object(F&& fields) {
+        out += '{';
+        fields();
+        // drop the last comma
+        if (out.back() == ',')
+            out.pop_back();
+        out += '}';
+    }
+
+    template <class F>
+    void Array(F&& element) {
+        out += '[';
+        for (int count = Below(4) + !Fault(10); count > 0; count--) {
+            element();
+            out += ',';
+        }
+        if (out.back() == ',')
+            out.pop_back();
+        out += ']';
+    }
+
+    // usually present with a value of its own type, sometimes missing, wrong, or repeated
+    template <class F>
+    void Field(std::string_view name, F&& value, bool required = false) {
+        if (required ? Fault(2) : Chance(30))
+            return;
+        for (int repeat = Fault(3) ? 2 : 1; repeat > 0; repeat--) {
+            out += '"';
+            out += name;
+            out += "\":";
+            if (Fault(3))
+                Pick(WrongTypes);
+            else
+                value();
+            out += ',';
+        }
+    }
+
+    void Judgement() {
+        Object([this]() {
+            Field("text", [this]() { Text(); }, true);
+            Field("color", [this]() { Color(); }, true);
+            Field("threshold", [this]() { Pick(Ints); });
+            Field("fade", [this]() { Bool(); });
+        });
+    }
+
+    void Bool() { out += Chance(50) ? "true" : "false"; }
+
+    void Text() {
+        out += '"';
+        for (int count = Below(8); count > 0; count--)
+            Pick(TextPieces);
+        out += '"';
+    }
+
+    void Color() {
+        out += '[';
+        for (int count = Fault(5) ? Below(6) : 4; count > 0; count--) {
+            out += Chance(90) ? "0.5" : Floats[Below(std::size(Floats))];
+            out += ',';
+        }
+        if (out.back() == ',')
+            out.pop_back();
+        out += ']';
+    }
+
+    // a few deletions, insertions, and truncations anywhere in the document
+    void Mutate() {
+        for (int count = 1 + Below(4); count > 0; count--) {
+            size_t pos = std::uniform_int_distribution<size_t>(0, out.size())(rng);
+            switch (Below(3)) {
+                case 0:
+                    out.erase(pos, 1 + Below(8));
+                    break;
+                case 1:
+                    out.insert(pos, Garbage[Below(std::size(Garbage))]);
+                    break;
+                default:
+                    out.resize(pos);
+                    break;
+            }
+        }
+    }
+
+    std::mt19937 rng;
+    std::string out;
+    bool faulty = false;
+};
+
+int main(int argc, char** argv) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 100000;
+    unsigned seed = argc > 2 ? std::atoi(argv[2]) : std::random_device()();
+    std::printf("running %ld iterations with seed %u\n", iterations, seed);
+
+    for (int i = 3; i < argc; i++) {
+        std::ifstream file(argv[i], std::ios::binary);
+        std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        Run(json);
+        // and every prefix of it, for each way a file can be cut short
+        for (size_t size = 0; size < json.size(); size++)
+            Run(std::string_view(json).substr(0, size));
+    }
+
+    Generator generator(seed);
+    for (long i = 0; i < iterations; i++)
+        Run(generator.Config());
+    std::printf("passed\n");
+    return 0;
+}
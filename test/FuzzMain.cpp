@@ -0,0 +1,64 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+
+// Runs a libFuzzer target without libFuzzer: first over a fixed corpus, then over random inputs built from pieces likely to matter.
+// fuzz_templates [iterations] [seed]
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size);
+
+static constexpr std::string_view Corpus[] = {
+    "%s",
+    "<size=80%>%s",
+    "<size=150%><u>%s</u></size>",
+    "%s%n%p%%",
+    "%B%s%A",
+    "%B%C%s</u>%A",
+    "%B<size=80%>%s</size>%A",
+    "%B<size=120%>%C%s</u></size>%A",
+    "<alpha=#80><size=80%>%s",
+    "Miss </3>",
+    "<noparse><u></u></noparse>",
+    "<noparse>%s<u></u></noparse></u>",
+    "%d %r %t %T %b %c %a %x %",
+};
+
+static constexpr std::string_view Pieces[] = {
+    "%",      "s",    "b",         "c",          "a",        "t",   "p", "B",        "C",        "A",        "T",         "d",
+    "r",      "n",    "x",         " ",          "<",        ">",   "/", "=",        "u",        "i",        "3",         "<u>",
+    "</u>",   "<b>",  "</B>",      "<color=red>", "</color>", "<size=80%>", "</size>", "<noparse>", "</noparse>", "<NoParse>", "<alpha=#80>", "↗",
+};
+
+static void Run(uint8_t selector, std::string_view templ) {
+    std::string input(1, (char) selector);
+    input += templ;
+    LLVMFuzzerTestOneInput((uint8_t const*) input.data(), input.size());
+}
+
+int main(int argc, char** argv) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 100000;
+    unsigned seed = argc > 2 ? std::atoi(argv[2]) : std::random_device()();
+    std::printf("running %ld iterations with seed %u\n", iterations, seed);
+
+    for (auto templ : Corpus) {
+        for (int selector = 0; selector < 256; selector++)
+            Run(selector, templ);
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> piece(0, std::size(Pieces) - 1);
+    std::uniform_int_distribution<int> length(0, 24);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::string templ;
+    for (long i = 0; i < iterations; i++) {
+        templ.clear();
+        for (int count = length(rng); count > 0; count--)
+            templ += Pieces[piece(rng)];
+        Run(byte(rng), templ);
+    }
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.hpp"
+#include "RichText.hpp"
+#include "TokenizedText.hpp"
+
+// Fuzz target for templates: libFuzzer calls it directly, and FuzzMain.cpp drives it with random inputs otherwise.
+// The first byte picks the values substituted for tokens, and the rest is the template.
+
+using Token = TokenizedText::Token;
+
+static constexpr std::string_view Specifiers = "bcatpBCATsdr";
+static constexpr Token SpecifierTokens[] = {
+    Token::BeforeCut,
+    Token::Accuracy,
+    Token::AfterCut,
+    Token::TimeDependency,
+    Token::Percent,
+    Token::BeforeCutSegment,
+    Token::AccuracySegment,
+    Token::AfterCutSegment,
+    Token::TimeDependencySegment,
+    Token::Score,
+    Token::Direction,
+    Token::RollingAverage,
+};
+
+// what a token can be replaced with during gameplay, including segments from configs
+static constexpr std::string_view ValuePool[] = {
+    "",
+    "0",
+    "115",
+    "-7",
+    "100.000000",
+    "45.5",
+    "↗",
+    " + ",
+    "<color=#ff4f4f> - </color>",
+    "<u>",
+    "</u>",
+    "%s",
+    "<noparse>",
+};
+
+// how the original TokenizedText formatted a template, substituting one specifier at a time
+static std::string ReferenceFormat(std::string_view str, TokenizedText::Values const& values) {
+    std::string out;
+    for (size_t i = 0; i < str.size(); i++) {
+        if (str[i] != '%') {
+            out += str[i];
+            continue;
+        }
+        // a trailing % is dropped
+        if (i + 1 == str.size())
+            break;
+        char specifier = str[++i];
+        if (specifier == 'n')
+            out += '\n';
+        else if (specifier == '%')
+            out += '%';
+        else if (size_t idx = Specifiers.find(specifier); idx != std::string_view::npos)
+            out += values[SpecifierTokens[idx]];
+        else {
+            out += '%';
+            out += specifier;
+        }
+    }
+    return out;
+}
+
+static constexpr std::string_view ReferenceScopedTags[] = {
+    "b", "i", "u", "s", "color", "size", "font", "font-weight", "mark", "sub", "sup", "smallcaps", "lowercase", "uppercase", "allcaps", "cspace", "voffset",
+};
+
+static std::string Lower(std::string_view str) {
+    std::string ret(str);
+    for (auto& c : ret)
+        c = std::tolower((unsigned char) c);
+    return ret;
+}
+
+static bool ReferenceScoped(std::string_view name) {
+    for (auto tag : ReferenceScopedTags) {
+        if (name == tag)
+            return true;
+    }
+    return false;
+}
+
+// a displayed character along with every scoped tag applied to it
+struct Glyph {
+    char c;
+    std::string style;
+    bool operator==(Glyph const&) const = default;
+};
+
+// A simple model of how TextMeshPro displays rich text: scoped tags style the text until closed,
+// noparse shows its contents as written, and anything else that looks like a tag is treated as text.
+static std::vector<Glyph> Render(std::string_view text) {
+    std::vector<Glyph> glyphs;
+    std::vector<std::pair<std::string, std::string>> open;
+    auto style = [&open]() {
+        std::string ret;
+        for (auto& [name, tag] : open)
+            ret += tag;
+        return ret;
+    };
+    size_t i = 0;
+    while (i < text.size()) {
+        // a tag can't contain <, which starts another tag instead
+        size_t end = text[i] == '<' ? text.find_first_of("<>", i + 1) : std::string_view::npos;
+        if (end != std::string_view::npos && text[end] == '>') {
+            auto tag = text.substr(i + 1, end - i - 1);
+            std::string name = Lower(tag.substr(0, tag.find_first_of("= ")));
+            if (name == "noparse") {
+                size_t close = Lower(text).find("</noparse>", end + 1);
+                size_t stop = close == std::string::npos ? text.size() : close;
+                for (size_t j = end + 1; j < stop; j++)
+                    glyphs.push_back({text[j], style()});
+                i = close == std::string::npos ? text.size() : close + 10;
+                continue;
+            }
+            if (ReferenceScoped(name)) {
+                open.emplace_back(name, Lower(tag));
+                i = end + 1;
+                continue;
+            }
+            if (name.starts_with('/') && ReferenceScoped(name.substr(1))) {
+                for (size_t j = open.size(); j > 0; j--) {
+                    if (open[j - 1].first == name.substr(1)) {
+                        open.erase(open.begin() + j - 1);
+                        break;
+                    }
+                }
+                i = end + 1;
+                continue;
+            }
+        }
+        glyphs.push_back({text[i], style()});
+        i++;
+    }
+    return glyphs;
+}
+
+static void Fail(char const* what, std::string_view templ, std::string_view actual, std::string_view expected) {
+    std::fprintf(
+        stderr,
+        "%s\n  template: \"%.*s\"\n  was:      \"%.*s\"\n  expected: \"%.*s\"\n",
+        what,
+        (int) templ.size(),
+        templ.data(),
+        (int) actual.size(),
+        actual.data(),
+        (int) expected.size(),
+        expected.data()
+    );
+    std::abort();
+}
+
+static void CheckRichText(std::string text) {
+    auto expected = Render(text);
+    std::string optimized = text;
+    HSV::RemoveEmptyTags(optimized);
+    HSV::RemoveTrailingClosingTags(optimized);
+    if (Render(optimized) != expected)
+        Fail("rich text passes changed the display", text, optimized, text);
+    // running them again finds nothing more to remove
+    std::string again = optimized;
+    HSV::RemoveEmptyTags(again);
+    HSV::RemoveTrailingClosingTags(again);
+    if (again != optimized)
+        Fail("rich text passes are not idempotent", text, again, optimized);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+    if (size == 0)
+        return 0;
+    std::string_view templ((char const*) data + 1, size - 1);
+
+    TokenizedText::Values values;
+    bool noparseValues = false;
+    for (size_t i = 0; i < std::size(SpecifierTokens); i++) {
+        // spread across the pool, with about half of the tokens left empty
+        size_t idx = (data[0] >> (i % 8) & 1) ? (data[0] + i * 7) % std::size(ValuePool) : 0;
+        auto value = ValuePool[idx];
+        values.Set(SpecifierTokens[i], value);
+        noparseValues |= HSV::OpensNoparse(value);
+    }
+
+    TokenizedText text{std::string(templ)};
+    std::string expected = ReferenceFormat(templ, values);
+    std::string formatted;
+    text.Format(values, formatted);
+    if (formatted != expected)
+        Fail("format differs from the reference", templ, formatted, expected);
+
+    // formatting appends, leaving what is already there alone
+    std::string appended = "x";
+    text.Format(values, appended);
+    if (appended != "x" + expected)
+        Fail("format doesn't append", templ, appended, "x" + expected);
+
+    for (size_t i = 0; i < std::size(SpecifierTokens); i++) {
+        bool used = false;
+        for (size_t j = 0; j + 1 < templ.size(); j++) {
+            if (templ[j] == '%') {
+                used |= templ[j + 1] == Specifiers[i];
+                j++;
+            }
+        }
+        CHECK(text.Uses(SpecifierTokens[i]) == used);
+    }
+
+    TokenizedText copy = text;
+    CHECK(copy == text);
+    std::string copied;
+    copy.Format(values, copied);
+    CHECK_TEXT(copied, expected);
+
+    CheckRichText(std::string(templ));
+
+    // like OptimizeTexts, templates aren't optimized when a segment could open a noparse
+    if (!noparseValues) {
+        TokenizedText optimized = text;
+        size_t removed = HSV::OptimizeRichText(optimized);
+        std::string optimizedText;
+        optimized.Format(values, optimizedText);
+        if (Render(optimizedText) != Render(expected))
+            Fail("optimizing the template changed the display", templ, optimizedText, expected);
+        // every literal appears exactly once in the output
+        CHECK(expected.size() - optimizedText.size() == removed);
+    }
+    return 0;
+}
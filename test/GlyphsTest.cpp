@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <string>
+
+#include "Check.hpp"
+#include "Glyphs.hpp"
+
+static std::string Collect(std::string judgement, std::string segment = "") {
+    HSV::Config config;
+    config.Judgements = {{0, TokenizedText(judgement), {1, 1, 1, 1}}};
+    config.AccuracySegments = {{0, segment}};
+    auto glyphs = HSV::CollectGlyphs(config);
+    return HSV::GlyphsToString(glyphs);
+}
+
+int main() {
+    // the digits, '.' and '-' are always included
+    CHECK_TEXT(Collect(""), "-.0123456789");
+    CHECK_TEXT(Collect("%s%n%p%%"), "%-.0123456789");
+    // tags aren't displayed, but what looks like a tag to people and not to TextMeshPro is
+    CHECK_TEXT(Collect("<size=80%><#ff0000>ab</size></B>"), "-.0123456789ab");
+    CHECK_TEXT(Collect("Miss </3>"), " -./0123456789<>Mis");
+    CHECK_TEXT(Collect("<noparse><b></noparse>", "<u>x</u>"), "-.0123456789<>bx");
+    CHECK_TEXT(Collect("%d"), "-.0123456789←↑→↓↖↗↘↙");
+
+    // a dynamic font with 'a' in its atlas and 'b' in its source, falling back to one with 'd' and 'e' and back to itself
+    UnityEngine::Font source, fallbackSource;
+    source.characters = {'a', 'b'};
+    fallbackSource.characters = {'e'};
+    TMPro::TMP_FontAsset font, fallback;
+    font.atlas = {'a'};
+    font.sourceFontFile = &source;
+    fallback.atlas = {'d'};
+    fallback.sourceFontFile = &fallbackSource;
+    System::Collections::Generic::List_1<TMPro::TMP_FontAsset*> fallbacks = {{&fallback}, 1}, loop = {{&font}, 1};
+    font.fallbackFontAssetTable = &fallbacks;
+    fallback.fallbackFontAssetTable = &loop;
+    std::vector<uint32_t> glyphs = {'a', 'b', 'c', 'd', 'e'};
+
+    // checking leaves the atlases alone, while populating adds what it can
+    CHECK(HSV::MissingGlyphs(&font, glyphs) == std::vector<uint32_t>({'c'}));
+    CHECK(font.atlas.size() == 1 && fallback.atlas.size() == 1);
+    CHECK(HSV::PopulateGlyphs(&font, glyphs) == std::vector<uint32_t>({'c'}));
+    CHECK(font.atlas.size() == 2 && fallback.atlas.size() == 2);
+    // a static font only has what is in its atlas
+    fallback.atlasPopulationMode = TMPro::AtlasPopulationMode::Static;
+    fallback.atlas = {'d'};
+    CHECK(HSV::MissingGlyphs(&font, glyphs) == std::vector<uint32_t>({'c', 'e'}));
+    CHECK(HSV::MissingGlyphs(nullptr, glyphs).empty());
+
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "Judgments.hpp"
+#include "json/DefaultConfig.hpp"
+
+// JudgeCut on the default config from 1 up to N threads at once, each with its own context, sharing one config.
+// judge_benchmark [notes per thread] [max threads]
+
+using Clock = std::chrono::steady_clock;
+using ScoringType = GlobalNamespace::NoteData::ScoringType;
+
+// a mix of normal notes, chain heads, and chain links across the whole range of scores
+static std::vector<HSV::CutScores> MakeNotes(size_t count) {
+    std::mt19937 rng(115);
+    std::vector<HSV::CutScores> notes(count);
+    for (auto& note : notes) {
+        int type = std::uniform_int_distribution<int>(0, 9)(rng);
+        if (type < 8) {
+            note.before = std::uniform_int_distribution<int>(40, 70)(rng);
+            note.after = std::uniform_int_distribution<int>(10, 30)(rng);
+            note.accuracy = std::uniform_int_distribution<int>(5, 15)(rng);
+            note.total = note.before + note.after + note.accuracy;
+            note.maxScore = 115;
+            note.scoringType = type == 7 ? ScoringType::ChainHead : ScoringType::Normal;
+            if (type == 7)
+                note.total -= note.after;
+        } else {
+            note.total = std::uniform_int_distribution<int>(0, 20)(rng);
+            note.maxScore = 20;
+            note.scoringType = ScoringType::ChainLink;
+        }
+        note.timeDependence = std::uniform_real_distribution<float>(0, 1)(rng);
+    }
+    return notes;
+}
+
+// a hash of every text and color, so threads can be checked against each other
+static size_t Judge(HSV::Config const& config, std::vector<HSV::CutScores> const& notes) {
+    HSV::JudgeContext context;
+    size_t hash = 0;
+    for (auto& note : notes) {
+        auto result = HSV::JudgeCut(config, note, context);
+        hash = hash * 31 + std::hash<std::string_view>()(result.text) + (size_t) (result.color.g * 255);
+    }
+    return hash;
+}
+
+int main(int argc, char** argv) {
+    size_t notes = argc > 1 ? std::atol(argv[1]) : 1000000;
+    unsigned maxThreads = argc > 2 ? std::atoi(argv[2]) : std::max(std::thread::hardware_concurrency(), 1u);
+
+    HSV::Config const config = DefaultConfig();
+    auto const input = MakeNotes(notes);
+    size_t const expected = Judge(config, input);
+
+    double single = 0;
+    std::printf("%7s %14s %14s %10s\n", "threads", "notes/s", "ns/note", "scaling");
+    for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount++) {
+        std::vector<size_t> hashes(threadCount);
+        std::vector<std::thread> threads;
+        auto start = Clock::now();
+        for (unsigned i = 0; i < threadCount; i++)
+            threads.emplace_back([&config, &input, &hashes, i]() { hashes[i] = Judge(config, input); });
+        for (auto& thread : threads)
+            thread.join();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // judging is the same on any thread, as nothing is shared except the const config
+        for (auto hash : hashes)
+            CHECK(hash == expected);
+        double rate = notes * threadCount / seconds;
+        if (threadCount == 1)
+            single = rate;
+        std::printf("%7u %14.0f %14.1f %9.2fx\n", threadCount, rate, 1e9 / rate, rate / single);
+    }
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "Check.hpp"
+#include "Judgments.hpp"
+#include "json/DefaultConfig.hpp"
+
+// Numbers formatted by JudgeCut with std::to_chars, against the std::to_string and std::stringstream formatting they replaced.
+// number_format_test [cases]
+
+// the previous formatting of each number token, separated the same way as the template below
+static std::string Reference(HSV::CutScores const& scores, int precision, int offset) {
+    int multiplier = std::pow(10, offset);
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(precision) << (scores.timeDependence * multiplier);
+    return std::to_string(scores.before) + "|" + std::to_string(scores.accuracy) + "|" + std::to_string(scores.after) + "|" +
+           std::to_string(scores.total) + "|" + std::to_string(round(100 * (float) scores.total / scores.maxScore)) + "|" + ss.str();
+}
+
+int main(int argc, char** argv) {
+    size_t cases = argc > 1 ? std::atol(argv[1]) : 300000;
+
+    auto config = DefaultConfig();
+    config.Judgements = {HSV::Judgement(0, TokenizedText("%b|%c|%a|%s|%p|%t"), {1, 1, 1, 1})};
+
+    // precisions up to the maximum of 99, and offsets up to 9 where the old int multiplier was exact
+    static constexpr int precisions[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 20, 50, 99};
+    std::mt19937 rng(300000);
+    HSV::JudgeContext context;
+    for (size_t i = 0; i < cases; i++) {
+        HSV::CutScores scores = {
+            .total = std::uniform_int_distribution<int>(0, 115)(rng),
+            .before = std::uniform_int_distribution<int>(0, 70)(rng),
+            .after = std::uniform_int_distribution<int>(0, 30)(rng),
+            .accuracy = std::uniform_int_distribution<int>(0, 15)(rng),
+            .timeDependence = std::uniform_real_distribution<float>(0, 1)(rng),
+            .maxScore = i % 4 ? 115 : 85,
+        };
+        config.TimeDependenceDecimalPrecision = precisions[i % std::size(precisions)];
+        config.TimeDependenceDecimalOffset = std::uniform_int_distribution<int>(0, 9)(rng);
+
+        auto result = HSV::JudgeCut(config, scores, context);
+        auto expected = Reference(scores, config.TimeDependenceDecimalPrecision, config.TimeDependenceDecimalOffset);
+        CHECK_TEXT(result.text, expected);
+    }
+    std::printf("%zu cases identical\n", cases);
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+#include "RichText.hpp"
+#include "json/DefaultConfig.hpp"
+
+using Token = TokenizedText::Token;
+
+static std::string Optimized(std::string text) {
+    HSV::RemoveEmptyTags(text);
+    HSV::RemoveTrailingClosingTags(text);
+    return text;
+}
+
+static std::string Format(TokenizedText const& text, TokenizedText::Values const& values) {
+    std::string ret;
+    text.Format(values, ret);
+    return ret;
+}
+
+static void TestPasses() {
+    CHECK_TEXT(Optimized("<u></u>"), "");
+    CHECK_TEXT(Optimized("a<b><i></I></b>c"), "ac");
+    CHECK_TEXT(Optimized("<color=red>x</color></size>"), "<color=red>x");
+    CHECK_TEXT(Optimized("<alpha=#80></alpha>"), "<alpha=#80></alpha>");
+    // only tags known to be scoped are removed from the end
+    CHECK_TEXT(Optimized("Miss </3>"), "Miss </3>");
+    CHECK_TEXT(Optimized("x</u></3>"), "x</u></3>");
+    // anything inside noparse is displayed as written
+    CHECK_TEXT(Optimized("<noparse><u></u></noparse>"), "<noparse><u></u></noparse>");
+    CHECK_TEXT(Optimized("<noparse></u>"), "<noparse></u>");
+    CHECK_TEXT(Optimized("<u></u><NOPARSE><b></b></NoParse><i></i>x</i>"), "<NOPARSE><b></b></NoParse>x");
+    // a < inside a tag starts a new one, and a stray < mustn't join with the text after a removed pair
+    CHECK_TEXT(Optimized("<x<noparse><u></u>"), "<x<noparse><u></u>");
+    CHECK_TEXT(Optimized("a<s<u></u>=1>b"), "a<s<u></u>=1>b");
+    CHECK(HSV::OpensNoparse("a<noparse>"));
+    CHECK(!HSV::OpensNoparse("<noparse>a</noparse>"));
+}
+
+// what judgments need appended before anything else shares their text, like the samples of the config preview
+static void TestClosingTags() {
+    CHECK_TEXT(HSV::ClosingTags("<size=150%><u>115"), "</u></size>");
+    CHECK_TEXT(HSV::ClosingTags("<color=red>a</color><b>"), "</b>");
+    // closing tags end the latest of their kind, even out of order, and stray ones and unscoped tags are ignored
+    CHECK_TEXT(HSV::ClosingTags("<u><b>x</u>"), "</b>");
+    CHECK_TEXT(HSV::ClosingTags("</i><alpha=#80>x"), "");
+    CHECK_TEXT(HSV::ClosingTags("<U>x"), "</u>");
+    CHECK_TEXT(HSV::ClosingTags("<u><noparse><b>"), "</noparse></u>");
+    CHECK_TEXT(HSV::ClosingTags("<noparse><b></noparse>x"), "");
+}
+
+static void TestTemplates() {
+    TokenizedText::Values values;
+    values.Set(Token::Score, "115");
+
+    TokenizedText text(std::string("<size=150%><u>%s</u></size>"));
+    CHECK(HSV::OptimizeRichText(text) == 11);
+    CHECK_TEXT(Format(text, values), "<size=150%><u>115");
+
+    // a noparse opened in an earlier literal still applies after a token
+    text = TokenizedText(std::string("<noparse>%s<u></u>%s</u>"));
+    CHECK(HSV::OptimizeRichText(text) == 0);
+    CHECK_TEXT(Format(text, values), "<noparse>115<u></u>115</u>");
+
+    text = TokenizedText(std::string("<noparse>%s</noparse><u></u>%s</u>"));
+    CHECK(HSV::OptimizeRichText(text) == 11);
+    CHECK_TEXT(Format(text, values), "<noparse>115</noparse>115");
+}
+
+// how much the passes save on the built-in config, per template and for the judgment text sent to TextMeshPro for each note
+static void ReportDefaultConfig() {
+    auto config = DefaultConfig();
+    TokenizedText::Values values;
+    values.Set(Token::Score, "115");
+    values.Set(Token::BeforeCutSegment, config.BeforeCutAngleSegments[0].Text);
+    values.Set(Token::AccuracySegment, config.AccuracySegments[0].Text);
+    values.Set(Token::AfterCutSegment, config.AfterCutAngleSegments[0].Text);
+
+    std::vector<HSV::Judgement*> judgements;
+    for (auto& judgement : config.Judgements)
+        judgements.push_back(&judgement);
+    for (auto& judgement : config.ChainHeadJudgements)
+        judgements.push_back(&judgement);
+    judgements.push_back(&*config.ChainLinkDisplay);
+
+    size_t templateBefore = 0, templateRemoved = 0, outputBefore = 0, outputAfter = 0;
+    std::printf("%-34s %6s %6s\n", "default config template", "before", "after");
+    for (auto judgement : judgements) {
+        std::string before = Format(judgement->Text, values);
+        templateBefore += judgement->Text.original.size();
+        templateRemoved += HSV::OptimizeRichText(judgement->Text);
+        std::string after = Format(judgement->Text, values);
+        CHECK(after.size() <= before.size());
+        outputBefore += before.size();
+        outputAfter += after.size();
+        std::printf("%-34s %6zu %6zu\n", judgement->Text.original.c_str(), before.size(), after.size());
+    }
+    std::printf(
+        "templates: %zu of %zu bytes removed (%.1f%%)\nformatted judgments: %zu -> %zu bytes (%.1f%% shorter)\n",
+        templateRemoved,
+        templateBefore,
+        100.0 * templateRemoved / templateBefore,
+        outputBefore,
+        outputAfter,
+        100.0 * (outputBefore - outputAfter) / outputBefore
+    );
+    CHECK(templateRemoved == 22);
+    CHECK(outputAfter + 22 == outputBefore);
+}
+
+int main() {
+    TestPasses();
+    TestClosingTags();
+    TestTemplates();
+    ReportDefaultConfig();
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A minimal client for the judgment stream, decoding frames as described in the README
+struct StreamEntry {
+    float songTime;
+    float timeDependence;
+    int16_t judgement;
+    uint8_t type;
+    uint8_t scoringType;
+    uint8_t before;
+    uint8_t after;
+    uint8_t accuracy;
+    uint8_t wrongDirection;
+    uint8_t score;
+    uint8_t color[4];
+};
+
+class StreamClient {
+   public:
+    static constexpr size_t EntrySize = 21;
+
+    StreamClient() = default;
+    StreamClient(StreamClient const&) = delete;
+    ~StreamClient() {
+        if (socket >= 0)
+            close(socket);
+    }
+
+    // Retries for a second while the server starts, optionally shrinking the receive buffer to act like a slow client
+    bool Connect(int port, int receiveBuffer = 0) {
+        for (int i = 0; i < 100; i++) {
+            socket = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (receiveBuffer > 0)
+                setsockopt(socket, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (connect(socket, (sockaddr*) &address, sizeof(address)) == 0)
+                return true;
+            close(socket);
+            socket = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    // Reads until out holds expected entries or nothing arrives for timeoutMs, appending every complete entry to out. Returns false on a malformed frame.
+    bool Receive(std::vector<StreamEntry>& out, int timeoutMs, size_t expected = SIZE_MAX) {
+        char chunk[65536];
+        pollfd poll = {socket, POLLIN, 0};
+        while (out.size() < expected && ::poll(&poll, 1, timeoutMs) > 0) {
+            ssize_t count = recv(socket, chunk, sizeof(chunk), 0);
+            if (count <= 0)
+                break;
+            buffer.append(chunk, count);
+            if (!Decode(out))
+                return false;
+        }
+        return true;
+    }
+
+   private:
+    template <class T>
+    static T Read(char const*& data) {
+        T ret;
+        std::memcpy(&ret, data, sizeof(T));
+        data += sizeof(T);
+        return ret;
+    }
+
+    bool Decode(std::vector<StreamEntry>& out) {
+        size_t used = 0;
+        while (buffer.size() - used >= 4) {
+            char const* data = buffer.data() + used;
+            uint32_t length = Read<uint32_t>(data);
+            if (buffer.size() - used - 4 < length)
+                break;
+            uint16_t count = Read<uint16_t>(data);
+            if (length != 2 + count * EntrySize)
+                return false;
+            for (int i = 0; i < count; i++) {
+                StreamEntry entry;
+                entry.songTime = Read<float>(data);
+                entry.timeDependence = Read<float>(data);
+                entry.judgement = Read<int16_t>(data);
+                entry.type = Read<uint8_t>(data);
+                entry.scoringType = Read<uint8_t>(data);
+                entry.before = Read<uint8_t>(data);
+                entry.after = Read<uint8_t>(data);
+                entry.accuracy = Read<uint8_t>(data);
+                entry.wrongDirection = Read<uint8_t>(data);
+                entry.score = Read<uint8_t>(data);
+                for (auto& channel : entry.color)
+                    channel = Read<uint8_t>(data);
+                out.push_back(entry);
+            }
+            used += 4 + length;
+        }
+        buffer.erase(0, used);
+        return true;
+    }
+
+    int socket = -1;
+    std::string buffer;
+};
@@ -0,0 +1,117 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "Stream.hpp"
+#include "StreamClient.hpp"
+
+// Delivery through the stream server to the client stub, what a slow client loses, and a throughput benchmark
+
+using Clock = std::chrono::steady_clock;
+
+static void Stream(int i) {
+    HSV::StreamEvent({.songTime = (float) i, .judgement = (int16_t) (i % 6), .before = 70, .after = 30, .accuracy = 15}, i % 116, {1, 0.5, 0, 1});
+}
+
+// sent in bursts that fit in the server's queue, each handed to the clients before the next
+static void StreamFlushed(int count, int burst) {
+    for (int i = 0; i < count; i++) {
+        Stream(i);
+        if (i % burst == burst - 1)
+            HSV::FlushStream();
+    }
+    HSV::FlushStream();
+}
+
+static void CheckOrdered(std::vector<StreamEntry> const& entries) {
+    for (size_t i = 1; i < entries.size(); i++)
+        CHECK(entries[i].songTime > entries[i - 1].songTime);
+}
+
+static void TestDelivery(int port) {
+    StreamClient client;
+    CHECK(client.Connect(port));
+    // accepted before anything is sent
+    HSV::FlushStream();
+    StreamFlushed(20000, 4000);
+
+    std::vector<StreamEntry> entries;
+    CHECK(client.Receive(entries, 1000, 20000));
+    CHECK(entries.size() == 20000);
+    CheckOrdered(entries);
+    auto& entry = entries[1234];
+    CHECK(entry.songTime == 1234 && entry.judgement == 1234 % 6 && entry.score == 1234 % 116);
+    CHECK(entry.before == 70 && entry.after == 30 && entry.accuracy == 15 && entry.wrongDirection == 0);
+    CHECK(entry.color[0] == 255 && entry.color[1] == 128 && entry.color[2] == 0 && entry.color[3] == 255);
+}
+
+static void TestSlowClient(int port) {
+    StreamClient client;
+    CHECK(client.Connect(port, 4096));
+    HSV::FlushStream();
+    // far more than the client's backlog, without reading any of it until the end
+    int count = 200000;
+    StreamFlushed(count, 4000);
+
+    std::vector<StreamEntry> entries;
+    CHECK(client.Receive(entries, 200));
+    std::printf("slow client received %zu of %d events\n", entries.size(), count);
+    // the oldest are skipped, and the newest always arrive
+    CHECK(!entries.empty() && entries.size() < (size_t) count);
+    CheckOrdered(entries);
+    CHECK(entries.back().songTime == count - 1);
+}
+
+// delivery at a steady rate for a quarter of a second, along with the cost to the game's thread of each event
+static void Benchmark(int port, int rate) {
+    StreamClient client;
+    CHECK(client.Connect(port));
+    HSV::FlushStream();
+
+    int count = rate / 4;
+    std::vector<StreamEntry> entries;
+    entries.reserve(count);
+    std::thread reader([&client, &entries]() { CHECK(client.Receive(entries, 200)); });
+
+    Clock::duration pushing = {};
+    auto start = Clock::now();
+    for (int i = 0; i < count;) {
+        int due = std::min<int>(count, std::chrono::duration<double>(Clock::now() - start).count() * rate);
+        auto before = Clock::now();
+        for (; i < due; i++)
+            Stream(i);
+        pushing += Clock::now() - before;
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    reader.join();
+
+    CheckOrdered(entries);
+    std::printf(
+        "%8d events/s: %6zu of %6d delivered (%5.1f%%), %.1f ns to push each\n",
+        rate,
+        entries.size(),
+        count,
+        100.0 * entries.size() / count,
+        std::chrono::duration<double, std::nano>(pushing).count() / count
+    );
+}
+
+int main() {
+    int port = 20000 + getpid() % 20000;
+    HSV::UpdateStreamServer(true, port);
+
+    TestDelivery(port);
+    TestSlowClient(port);
+    // the server drains at most the queue's 4096 entries every 10ms
+    for (int rate : {10000, 100000, 400000, 1000000, 4000000})
+        Benchmark(port, rate);
+
+    HSV::UpdateStreamServer(false, port);
+    std::printf("passed\n");
+    return 0;
+}
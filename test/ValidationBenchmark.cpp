@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "Validation.hpp"
+
+// ValidateConfigs then WriteValidationReport on every .json file under a directory, from 1 up to N threads.
+// validation_benchmark <directory> [report path] [max threads]
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<std::string> FindConfigs(std::filesystem::path const& directory) {
+    std::vector<std::string> paths;
+    for (auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json")
+            paths.emplace_back(entry.path().string());
+    }
+    // the same order as the config list, so the report is too
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <directory> [report path] [max threads]\n", argv[0]);
+        return 1;
+    }
+    auto paths = FindConfigs(argv[1]);
+    std::string report = argc > 2 ? argv[2] : "validation.tsv";
+    unsigned maxThreads = argc > 3 ? std::atoi(argv[3]) : std::max(std::thread::hardware_concurrency(), 1u);
+    CHECK(!paths.empty());
+
+    std::vector<HSV::ValidationResult> expected;
+    double single = 0;
+    std::printf("%d configs under %s\n", (int) paths.size(), argv[1]);
+    std::printf("%7s %14s %12s %10s\n", "threads", "configs/s", "ms", "scaling");
+    for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount++) {
+        auto start = Clock::now();
+        auto results = HSV::ValidateConfigs(paths, threadCount);
+        HSV::WriteValidationReport(report, results);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // each config is loaded on its own, so the results can't depend on how many threads shared the work
+        CHECK(results.size() == paths.size());
+        if (threadCount == 1)
+            expected = results;
+        for (size_t i = 0; i < results.size(); i++) {
+            CHECK_TEXT(results[i].path, paths[i]);
+            CHECK(results[i].error == expected[i].error);
+            CHECK(results[i].glyphs == expected[i].glyphs);
+        }
+        double rate = paths.size() / seconds;
+        if (threadCount == 1)
+            single = rate;
+        std::printf("%7u %14.0f %12.2f %9.2fx\n", threadCount, rate, seconds * 1e3, rate / single);
+    }
+
+    int failed = std::count_if(expected.begin(), expected.end(), [](HSV::ValidationResult const& result) { return result.error.has_value(); });
+    std::printf("%d failed, report written to %s\n", failed, report.c_str());
+    std::printf("passed\n");
+    return 0;
+}
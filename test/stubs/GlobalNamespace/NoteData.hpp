@@ -0,0 +1,19 @@
+#pragma once
+
+// Host stand-in for the il2cpp binding, with only the scoring types, numbered as in the game
+namespace GlobalNamespace {
+    struct NoteData {
+        enum class ScoringType {
+            Ignore = -1,
+            NoScore,
+            Normal,
+            ArcHead,
+            ArcTail,
+            ChainHead,
+            ChainLink,
+            ArcHeadArcTail,
+            ChainHeadArcTail,
+            ChainLinkArcHead,
+        };
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <fmt/format.h>
+
+// Host stand-in for the mod's Main.hpp, with only the logger, which prints to stderr
+
+struct HostLogger {
+    template <class... TArgs>
+    void info(fmt::format_string<TArgs...> str, TArgs&&... args) const {
+        fmt::print(stderr, "[info] {}\n", fmt::format(str, std::forward<TArgs>(args)...));
+    }
+    template <class... TArgs>
+    void debug(fmt::format_string<TArgs...> str, TArgs&&... args) const {
+        fmt::print(stderr, "[debug] {}\n", fmt::format(str, std::forward<TArgs>(args)...));
+    }
+    template <class... TArgs>
+    void warn(fmt::format_string<TArgs...> str, TArgs&&... args) const {
+        fmt::print(stderr, "[warn] {}\n", fmt::format(str, std::forward<TArgs>(args)...));
+    }
+    template <class... TArgs>
+    void error(fmt::format_string<TArgs...> str, TArgs&&... args) const {
+        fmt::print(stderr, "[error] {}\n", fmt::format(str, std::forward<TArgs>(args)...));
+    }
+};
+
+inline HostLogger const logger;
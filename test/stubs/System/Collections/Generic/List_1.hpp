@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+
+// Host stand-in for the il2cpp binding, with only what's used to iterate over one
+namespace System::Collections::Generic {
+    template <class T>
+    struct List_1 {
+        T get_Item(int index) { return items[index]; }
+
+        std::vector<T> items;
+        int Count = 0;
+    };
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// Host stand-in for the il2cpp binding
+namespace TMPro {
+    enum class AtlasPopulationMode {
+        Static,
+        Dynamic,
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+
+#include "System/Collections/Generic/List_1.hpp"
+#include "TMPro/AtlasPopulationMode.hpp"
+#include "UnityEngine/Font.hpp"
+
+// Host stand-in for the il2cpp binding, as a font with a fixed set of characters already in its atlas,
+// adding from its source font when asked to if it's dynamic
+namespace TMPro {
+    struct TMP_FontAsset {
+        bool HasCharacter(uint32_t character, bool searchFallbacks, bool tryAddCharacter) {
+            std::set<TMP_FontAsset*> searched;
+            return HasCharacter(character, searchFallbacks, tryAddCharacter, searched);
+        }
+
+        std::set<uint32_t> atlas;
+        AtlasPopulationMode atlasPopulationMode = AtlasPopulationMode::Dynamic;
+        UnityEngine::Font* sourceFontFile = nullptr;
+        System::Collections::Generic::List_1<TMP_FontAsset*>* fallbackFontAssetTable = nullptr;
+
+       private:
+        // fallbacks can refer back to each other, which TextMeshPro stops at as well
+        bool HasCharacter(uint32_t character, bool searchFallbacks, bool tryAddCharacter, std::set<TMP_FontAsset*>& searched) {
+            if (!searched.insert(this).second)
+                return false;
+            if (atlas.contains(character))
+                return true;
+            if (tryAddCharacter && atlasPopulationMode == AtlasPopulationMode::Dynamic && sourceFontFile && sourceFontFile->characters.contains(character)) {
+                atlas.insert(character);
+                return true;
+            }
+            for (int i = 0; searchFallbacks && fallbackFontAssetTable && i < fallbackFontAssetTable->Count; i++) {
+                if (fallbackFontAssetTable->get_Item(i)->HasCharacter(character, true, tryAddCharacter, searched))
+                    return true;
+            }
+            return false;
+        }
+    };
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// Host stand-in for the il2cpp binding, with the same fields and constructor
+namespace UnityEngine {
+    struct Color {
+        constexpr Color() = default;
+        constexpr Color(float r, float g, float b, float a) : r(r), g(g), b(b), a(a) {}
+
+        float r = 0;
+        float g = 0;
+        float b = 0;
+        float a = 0;
+    };
+}
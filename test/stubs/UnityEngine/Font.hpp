@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+
+// Host stand-in for the il2cpp binding, with the characters the font file has
+namespace UnityEngine {
+    struct Font {
+        bool HasCharacter(char16_t character) { return characters.contains(character); }
+
+        std::set<uint32_t> characters;
+    };
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in for the il2cpp binding, with the same fields and constructor
+namespace UnityEngine {
+    struct Vector3 {
+        constexpr Vector3() = default;
+        constexpr Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+}
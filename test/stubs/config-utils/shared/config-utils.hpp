@@ -0,0 +1,420 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <charconv>
+#include <climits>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Host stand-in for config-utils and rapidjson-macros, which aren't available outside the qpm build.
+// Deserializes the same way: every NAMED_VALUE and DESERIALIZE_FUNCTION runs in declaration order, a missing required value
+// or a value of the wrong type throws JSONException, and so does any parse error, with the path to the value in the message.
+
+struct JSONException : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+namespace HostJson {
+    struct Value {
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        Type type = Type::Null;
+        bool boolean = false;
+        double number = 0;
+        // a number without a fraction or exponent that fits in an int, like rapidjson's IsInt
+        std::optional<int> integer;
+        std::string string;
+        std::vector<Value> array;
+        std::vector<std::pair<std::string, Value>> object;
+
+        // the first member named name, like rapidjson's FindMember, or null if there isn't one
+        Value const* Find(std::string_view name) const {
+            for (auto& [key, value] : object) {
+                if (key == name)
+                    return &value;
+            }
+            return nullptr;
+        }
+    };
+
+    // A strict parser for a single JSON document, like rapidjson with its default flags.
+    // Nesting is limited only so that fuzzing can't overflow the stack.
+    class Parser {
+       public:
+        static constexpr int MaxDepth = 512;
+
+        explicit Parser(std::string_view text) : text(text) {}
+
+        Value ParseDocument() {
+            Value ret = ParseValue(0);
+            SkipWhitespace();
+            if (pos != text.size())
+                Fail("the document root must not be followed by other values");
+            return ret;
+        }
+
+       private:
+        [[noreturn]] void Fail(char const* error) const { throw JSONException(fmt::format("parse error at offset {}: {}", pos, error)); }
+
+        void SkipWhitespace() {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+                pos++;
+        }
+
+        bool Consume(char c) {
+            if (pos < text.size() && text[pos] == c) {
+                pos++;
+                return true;
+            }
+            return false;
+        }
+
+        bool ConsumeWord(std::string_view word) {
+            if (text.substr(pos, word.size()) != word)
+                return false;
+            pos += word.size();
+            return true;
+        }
+
+        Value ParseValue(int depth) {
+            if (depth > MaxDepth)
+                Fail("too deeply nested");
+            SkipWhitespace();
+            if (pos == text.size())
+                Fail("the document is empty");
+            Value ret;
+            char c = text[pos];
+            if (c == '{') {
+                ret.type = Value::Type::Object;
+                pos++;
+                SkipWhitespace();
+                if (Consume('}'))
+                    return ret;
+                do {
+                    SkipWhitespace();
+                    if (pos == text.size() || text[pos] != '"')
+                        Fail("missing a name for an object member");
+                    std::string name = ParseString();
+                    SkipWhitespace();
+                    if (!Consume(':'))
+                        Fail("missing a colon after a name of an object member");
+                    ret.object.emplace_back(std::move(name), ParseValue(depth + 1));
+                    SkipWhitespace();
+                } while (Consume(','));
+                if (!Consume('}'))
+                    Fail("missing a comma or '}' after an object member");
+            } else if (c == '[') {
+                ret.type = Value::Type::Array;
+                pos++;
+                SkipWhitespace();
+                if (Consume(']'))
+                    return ret;
+                do {
+                    ret.array.emplace_back(ParseValue(depth + 1));
+                    SkipWhitespace();
+                } while (Consume(','));
+                if (!Consume(']'))
+                    Fail("missing a comma or ']' after an array element");
+            } else if (c == '"') {
+                ret.type = Value::Type::String;
+                ret.string = ParseString();
+            } else if (ConsumeWord("true") || ConsumeWord("false")) {
+                ret.type = Value::Type::Bool;
+                ret.boolean = c == 't';
+            } else if (ConsumeWord("null")) {
+                ret.type = Value::Type::Null;
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                ParseNumber(ret);
+            } else
+                Fail("invalid value");
+            return ret;
+        }
+
+        void ParseNumber(Value& value) {
+            size_t start = pos;
+            auto digits = [this]() {
+                size_t first = pos;
+                while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+                    pos++;
+                return pos - first;
+            };
+            Consume('-');
+            size_t intStart = pos;
+            if (digits() == 0)
+                Fail("invalid value");
+            if (text[intStart] == '0' && pos - intStart > 1)
+                Fail("leading zeros are not allowed");
+            bool isInteger = true;
+            if (Consume('.')) {
+                isInteger = false;
+                if (digits() == 0)
+                    Fail("missing fraction part in number");
+            }
+            if (Consume('e') || Consume('E')) {
+                isInteger = false;
+                if (!Consume('+'))
+                    Consume('-');
+                if (digits() == 0)
+                    Fail("missing exponent in number");
+            }
+            auto number = text.substr(start, pos - start);
+            auto result = std::from_chars(number.data(), number.data() + number.size(), value.number);
+            if (result.ec == std::errc::result_out_of_range)
+                Fail("number too big to be stored in double");
+            value.type = Value::Type::Number;
+            if (isInteger && value.number >= INT_MIN && value.number <= INT_MAX)
+                value.integer = (int) value.number;
+        }
+
+        unsigned ParseHex4() {
+            if (pos + 4 > text.size())
+                Fail("incorrect hex digit after \\u escape in string");
+            unsigned ret = 0;
+            auto result = std::from_chars(text.data() + pos, text.data() + pos + 4, ret, 16);
+            if (result.ptr != text.data() + pos + 4)
+                Fail("incorrect hex digit after \\u escape in string");
+            pos += 4;
+            return ret;
+        }
+
+        static void AppendUtf8(std::string& out, unsigned codepoint) {
+            if (codepoint < 0x80)
+                out += (char) codepoint;
+            else if (codepoint < 0x800)
+                out += {(char) (0xc0 | codepoint >> 6), (char) (0x80 | (codepoint & 0x3f))};
+            else if (codepoint < 0x10000)
+                out += {(char) (0xe0 | codepoint >> 12), (char) (0x80 | (codepoint >> 6 & 0x3f)), (char) (0x80 | (codepoint & 0x3f))};
+            else
+                out += {(char) (0xf0 | codepoint >> 18),
+                        (char) (0x80 | (codepoint >> 12 & 0x3f)),
+                        (char) (0x80 | (codepoint >> 6 & 0x3f)),
+                        (char) (0x80 | (codepoint & 0x3f))};
+        }
+
+        std::string ParseString() {
+            std::string ret;
+            pos++;
+            while (true) {
+                if (pos == text.size())
+                    Fail("missing a closing quotation mark in string");
+                char c = text[pos++];
+                if (c == '"')
+                    return ret;
+                if ((unsigned char) c < 0x20)
+                    Fail("invalid encoding in string");
+                if (c != '\\') {
+                    ret += c;
+                    continue;
+                }
+                if (pos == text.size())
+                    Fail("missing a closing quotation mark in string");
+                switch (char escape = text[pos++]) {
+                    case '"':
+                    case '\\':
+                    case '/':
+                        ret += escape;
+                        break;
+                    case 'b':
+                        ret += '\b';
+                        break;
+                    case 'f':
+                        ret += '\f';
+                        break;
+                    case 'n':
+                        ret += '\n';
+                        break;
+                    case 'r':
+                        ret += '\r';
+                        break;
+                    case 't':
+                        ret += '\t';
+                        break;
+                    case 'u': {
+                        unsigned codepoint = ParseHex4();
+                        if (codepoint >= 0xdc00 && codepoint <= 0xdfff)
+                            Fail("the surrogate pair in string is invalid");
+                        if (codepoint >= 0xd800 && codepoint <= 0xdbff) {
+                            if (!ConsumeWord("\\u"))
+                                Fail("the surrogate pair in string is invalid");
+                            unsigned low = ParseHex4();
+                            if (low < 0xdc00 || low > 0xdfff)
+                                Fail("the surrogate pair in string is invalid");
+                            codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                        }
+                        AppendUtf8(ret, codepoint);
+                        break;
+                    }
+                    default:
+                        Fail("invalid escape character in string");
+                }
+            }
+        }
+
+        std::string_view text;
+        size_t pos = 0;
+    };
+
+    // Base of every JSON struct, holding the deserialization steps its macros register in order
+    template <class T>
+    struct Struct {
+        using SelfType = T;
+        using Step = void (*)(T& self, Value const& json);
+
+        static std::vector<Step>& Steps() {
+            static std::vector<Step> steps;
+            return steps;
+        }
+        static bool Register(Step step) {
+            Steps().push_back(step);
+            return true;
+        }
+    };
+
+    template <class T>
+    concept JsonStruct = std::is_base_of_v<Struct<T>, T>;
+
+    // an error from a nested value, with where it came from added to the front
+    inline JSONException Nested(std::string_view name, JSONException const& error) {
+        std::string_view what = error.what();
+        bool separate = !what.empty() && std::string_view(":[, ").find(what[0]) == std::string_view::npos;
+        return JSONException(fmt::format("{}{}{}", name, separate ? "." : "", what));
+    }
+
+    inline void Deserialize(Value const& json, bool& out) {
+        if (json.type != Value::Type::Bool)
+            throw JSONException(", type expected was: bool");
+        out = json.boolean;
+    }
+    inline void Deserialize(Value const& json, int& out) {
+        if (!json.integer)
+            throw JSONException(", type expected was: int");
+        out = *json.integer;
+    }
+    inline void Deserialize(Value const& json, float& out) {
+        if (json.type != Value::Type::Number)
+            throw JSONException(", type expected was: float");
+        out = (float) json.number;
+    }
+    inline void Deserialize(Value const& json, std::string& out) {
+        if (json.type != Value::Type::String)
+            throw JSONException(", type expected was: string");
+        out = json.string;
+    }
+    template <JsonStruct T>
+    void Deserialize(Value const& json, T& out) {
+        for (auto step : Struct<T>::Steps())
+            step(out, json);
+    }
+    template <class T>
+    void Deserialize(Value const& json, std::vector<T>& out) {
+        if (json.type != Value::Type::Array)
+            throw JSONException(", type expected was: array");
+        out.clear();
+        for (size_t i = 0; i < json.array.size(); i++) {
+            try {
+                Deserialize(json.array[i], out.emplace_back());
+            } catch (JSONException const& error) {
+                throw Nested(fmt::format("[{}]", i), error);
+            }
+        }
+    }
+
+    // the member named name of json, or json itself when name is empty
+    inline Value const* Member(Value const& json, std::string_view name) {
+        if (name.empty())
+            return &json;
+        if (json.type != Value::Type::Object)
+            throw JSONException(", type expected was: object");
+        return json.Find(name);
+    }
+
+    template <class T>
+    void Read(Value const& json, std::string_view name, T& out) {
+        auto value = Member(json, name);
+        if (!value)
+            throw JSONException(fmt::format("{} not found", name));
+        try {
+            Deserialize(*value, out);
+        } catch (JSONException const& error) {
+            throw Nested(name, error);
+        }
+    }
+
+    template <class T, class F>
+    void ReadDefault(Value const& json, std::string_view name, T& out, F&& makeDefault) {
+        if (Member(json, name))
+            Read(json, name, out);
+        else
+            out = makeDefault();
+    }
+
+    template <class T>
+    void ReadOptional(Value const& json, std::string_view name, std::optional<T>& out) {
+        auto value = Member(json, name);
+        if (!value || value->type == Value::Type::Null) {
+            out = std::nullopt;
+            return;
+        }
+        T ret;
+        Read(json, name, ret);
+        out = std::move(ret);
+    }
+}
+
+#define DECLARE_JSON_STRUCT(name) struct name : HostJson::Struct<name>
+#define SELF_OBJECT_NAME ""
+
+// the lambdas are generic so that their bodies are only checked once the struct is complete
+#define HOST_JSON_STEP(name, ...) \
+    static inline bool const _HostJsonStep_##name = Register([](auto& self, HostJson::Value const& json) -> void { __VA_ARGS__; })
+
+#define NAMED_VALUE(type, name, jsonName) \
+    type name = {};                       \
+    HOST_JSON_STEP(name, HostJson::Read(json, jsonName, self.name))
+#define NAMED_VALUE_DEFAULT(type, name, def, jsonName) \
+    type name = def;                                   \
+    HOST_JSON_STEP(name, HostJson::ReadDefault(json, jsonName, self.name, []() -> type { return def; }))
+#define NAMED_VALUE_OPTIONAL(type, name, jsonName) \
+    std::optional<type> name = std::nullopt;       \
+    HOST_JSON_STEP(name, HostJson::ReadOptional(json, jsonName, self.name))
+#define NAMED_VECTOR(type, name, jsonName) \
+    std::vector<type> name = {};           \
+    HOST_JSON_STEP(name, HostJson::Read(json, jsonName, self.name))
+#define NAMED_VECTOR_DEFAULT(type, name, def, jsonName) \
+    std::vector<type> name = def;                       \
+    HOST_JSON_STEP(name, HostJson::ReadDefault(json, jsonName, self.name, []() -> std::vector<type> { return def; }))
+#define DESERIALIZE_FUNCTION(name) \
+    HOST_JSON_STEP(name, self.name()); \
+    void name()
+
+template <HostJson::JsonStruct T>
+void ReadFromString(std::string_view string, T& out) {
+    HostJson::Deserialize(HostJson::Parser(string).ParseDocument(), out);
+}
+
+template <HostJson::JsonStruct T>
+void ReadFromFile(std::string_view path, T& out) {
+    std::ifstream file{std::string(path), std::ios::binary};
+    if (!file)
+        throw JSONException(fmt::format("could not read file {}", path));
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ReadFromString(contents, out);
+}
+
+namespace ConfigUtils {
+    DECLARE_JSON_STRUCT(Vector3) {
+        NAMED_VALUE(float, x, "x");
+        NAMED_VALUE(float, y, "y");
+        NAMED_VALUE(float, z, "z");
+
+        Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
+        Vector3() = default;
+    };
+}